@@ -0,0 +1,162 @@
+/***********************************************************************
+ * Header File:
+ *    ATTACKS
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    The squares each kind of piece attacks from a given location,
+ *    as bitboards. Sliding pieces stop at the first occupied square
+ *    in each direction (that square is included: it may be a capture).
+ *    Every table but the magic ones is built by the compiler, so there
+ *    is nothing to fill in when the program starts.
+ ************************************************************************/
+
+#pragma once
+
+#include "bitboard.h"
+#include "magic.h"     // for the rook and bishop lookups
+
+/***************************************************
+ * DIRECTION
+ * The eight ways a piece can slide. The first four walk
+ * toward higher locations, the last four toward lower,
+ * and each is opposite the one four places away
+ ***************************************************/
+enum Direction
+{
+   NORTH, EAST, NORTH_EAST, NORTH_WEST,
+   SOUTH, WEST, SOUTH_WEST, SOUTH_EAST
+};
+
+constexpr int DIRECTION_COL[8] = { 0, 1,  1, -1,  0, -1, -1,  1 };
+constexpr int DIRECTION_ROW[8] = { 1, 0,  1,  1, -1,  0, -1, -1 };
+
+constexpr bool isIncreasing(int direction) { return direction < SOUTH;   }
+constexpr int  opposite(int direction)     { return (direction + 4) % 8; }
+
+/***************************************************
+ * ATTACK TABLES
+ * The squares attacked from each location by the pieces
+ * that do not slide, the eight rays a slider could follow
+ * on an empty board, and the lines joining two squares.
+ * Two squares not on a common rank, file or diagonal have
+ * empty between and line entries
+ ***************************************************/
+struct AttackTables
+{
+   Bitboard knight[64];
+   Bitboard king[64];
+   Bitboard pawn[2][64];      // [white, black][location]
+   Bitboard rays[8][64];      // [Direction][location], the start excluded
+   Bitboard bishopRays[64];   // empty-board bishop moves
+   Bitboard rookRays[64];     // empty-board rook moves
+   Bitboard between[64][64];  // the squares strictly between two on a line
+   Bitboard line[64][64];     // the whole line through two squares, edge to edge
+};
+
+/***************************************************
+ * MAKE ATTACK TABLES
+ * Step from every square, dropping the steps that
+ * would leave the board
+ ***************************************************/
+constexpr AttackTables makeAttackTables()
+{
+   AttackTables t = {};
+   const int knightCol[8] = { 1, 2,  2,  1, -1, -2, -2, -1 };
+   const int knightRow[8] = { 2, 1, -1, -2, -2, -1,  1,  2 };
+
+   for (int from = 0; from < 64; from++)
+   {
+      int col = colOf(from);
+      int row = rowOf(from);
+
+      for (int i = 0; i < 8; i++)
+      {
+         int c = col + knightCol[i];
+         int r = row + knightRow[i];
+         if (c >= 0 && c < 8 && r >= 0 && r < 8)
+            t.knight[from] |= squareBit(squareOf(c, r));
+      }
+
+      for (int d = 0; d < 8; d++)
+      {
+         int c = col + DIRECTION_COL[d];
+         int r = row + DIRECTION_ROW[d];
+         if (c >= 0 && c < 8 && r >= 0 && r < 8)
+            t.king[from] |= squareBit(squareOf(c, r));
+         for (; c >= 0 && c < 8 && r >= 0 && r < 8; c += DIRECTION_COL[d], r += DIRECTION_ROW[d])
+            t.rays[d][from] |= squareBit(squareOf(c, r));
+      }
+
+      Bitboard bb = squareBit(from);
+      t.pawn[0][from] = shiftEast(shiftNorth(bb)) | shiftWest(shiftNorth(bb));
+      t.pawn[1][from] = shiftEast(shiftSouth(bb)) | shiftWest(shiftSouth(bb));
+   }
+
+   for (int from = 0; from < 64; from++)
+   {
+      t.rookRays[from]   = t.rays[NORTH][from]      | t.rays[SOUTH][from] |
+                           t.rays[EAST][from]       | t.rays[WEST][from];
+      t.bishopRays[from] = t.rays[NORTH_EAST][from] | t.rays[SOUTH_WEST][from] |
+                           t.rays[NORTH_WEST][from] | t.rays[SOUTH_EAST][from];
+
+      // walk each ray, remembering the path
+      for (int d = 0; d < 8; d++)
+      {
+         Bitboard whole = squareBit(from) | t.rays[d][from] | t.rays[opposite(d)][from];
+         Bitboard path = EMPTY_BB;
+         int c = colOf(from) + DIRECTION_COL[d];
+         int r = rowOf(from) + DIRECTION_ROW[d];
+         for (; c >= 0 && c < 8 && r >= 0 && r < 8; c += DIRECTION_COL[d], r += DIRECTION_ROW[d])
+         {
+            int to = squareOf(c, r);
+            t.between[from][to] = path;
+            t.line[from][to]    = whole;
+            path |= squareBit(to);
+         }
+      }
+   }
+   return t;
+}
+
+inline constexpr AttackTables ATTACKS = makeAttackTables();
+
+inline Bitboard knightAttacks(int location)             { return ATTACKS.knight[location];                }
+inline Bitboard kingAttacks(int location)               { return ATTACKS.king[location];                  }
+inline Bitboard pawnAttacks(int location, bool isWhite) { return ATTACKS.pawn[isWhite ? 0 : 1][location]; }
+
+/***************************************************
+ * RAY ATTACKS
+ * Follow one ray from a location up to and including the
+ * first occupied square: everything past that square is
+ * that square's own ray in the same direction
+ ***************************************************/
+inline Bitboard rayAttacks(int location, Bitboard occupied, int direction)
+{
+   Bitboard attacks  = ATTACKS.rays[direction][location];
+   Bitboard blockers = attacks & occupied;
+   if (blockers)
+      attacks ^= ATTACKS.rays[direction][isIncreasing(direction) ? lsb(blockers) : msb(blockers)];
+   return attacks;
+}
+
+/***************************************************
+ * BISHOP / ROOK ATTACKS
+ * One magic lookup each: see magic.h
+ ***************************************************/
+inline Bitboard bishopAttacks(int location, Bitboard occupied)
+{
+   const Magic & m = BISHOP_MAGICS[location];
+   return m.attacks[m.index(occupied)];
+}
+
+inline Bitboard rookAttacks(int location, Bitboard occupied)
+{
+   const Magic & m = ROOK_MAGICS[location];
+   return m.attacks[m.index(occupied)];
+}
+
+inline Bitboard queenAttacks(int location, Bitboard occupied)
+{
+   return bishopAttacks(location, occupied) | rookAttacks(location, occupied);
+}
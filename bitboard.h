@@ -0,0 +1,156 @@
+/***********************************************************************
+ * Header File:
+ *    BITBOARD
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    A set of squares packed into a single 64-bit word. Bit n is the
+ *    square whose location is n (row * 8 + col), so a1 is bit 0 and
+ *    h8 is bit 63. This matches Position::getLocation().
+ ************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <cassert>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+typedef uint64_t Bitboard;
+
+constexpr Bitboard EMPTY_BB = 0x0000000000000000ULL;
+constexpr Bitboard FILE_A   = 0x0101010101010101ULL;
+constexpr Bitboard FILE_B   = FILE_A << 1;
+constexpr Bitboard FILE_G   = FILE_A << 6;
+constexpr Bitboard FILE_H   = FILE_A << 7;
+constexpr Bitboard RANK_1   = 0x00000000000000ffULL;
+constexpr Bitboard RANK_2   = RANK_1 << (8 * 1);
+constexpr Bitboard RANK_3   = RANK_1 << (8 * 2);
+constexpr Bitboard RANK_4   = RANK_1 << (8 * 3);
+constexpr Bitboard RANK_5   = RANK_1 << (8 * 4);
+constexpr Bitboard RANK_6   = RANK_1 << (8 * 5);
+constexpr Bitboard RANK_7   = RANK_1 << (8 * 6);
+constexpr Bitboard RANK_8   = RANK_1 << (8 * 7);
+
+/***************************************************
+ * SQUARE BIT
+ * The bitboard with only the given location set
+ ***************************************************/
+constexpr Bitboard squareBit(int location)
+{
+   assert(location >= 0 && location < 64);
+   return 1ULL << location;
+}
+
+constexpr int squareOf(int col, int row) { return row * 8 + col; }
+constexpr int colOf(int location)        { return location & 7;   }
+constexpr int rowOf(int location)        { return location >> 3;  }
+
+/***************************************************
+ * POP COUNT
+ * How many squares are in the set?
+ ***************************************************/
+inline int popCount(Bitboard bb)
+{
+#if defined(__GNUC__) || defined(__clang__)
+   return __builtin_popcountll(bb);
+#elif defined(_MSC_VER) && defined(_WIN64)
+   return (int)__popcnt64(bb);
+#else
+   int count = 0;
+   for (; bb; bb &= bb - 1)
+      count++;
+   return count;
+#endif
+}
+
+/***************************************************
+ * LSB
+ * The location of the lowest square in a non-empty set
+ ***************************************************/
+inline int lsb(Bitboard bb)
+{
+   assert(bb != 0);
+#if defined(__GNUC__) || defined(__clang__)
+   return __builtin_ctzll(bb);
+#elif defined(_MSC_VER) && defined(_WIN64)
+   unsigned long index;
+   _BitScanForward64(&index, bb);
+   return (int)index;
+#else
+   unsigned long index;
+   if (_BitScanForward(&index, (unsigned long)bb))
+      return (int)index;
+   _BitScanForward(&index, (unsigned long)(bb >> 32));
+   return (int)index + 32;
+#endif
+}
+
+/***************************************************
+ * MSB
+ * The location of the highest square in a non-empty set
+ ***************************************************/
+inline int msb(Bitboard bb)
+{
+   assert(bb != 0);
+#if defined(__GNUC__) || defined(__clang__)
+   return 63 - __builtin_clzll(bb);
+#elif defined(_MSC_VER) && defined(_WIN64)
+   unsigned long index;
+   _BitScanReverse64(&index, bb);
+   return (int)index;
+#else
+   unsigned long index;
+   if (_BitScanReverse(&index, (unsigned long)(bb >> 32)))
+      return (int)index + 32;
+   _BitScanReverse(&index, (unsigned long)bb);
+   return (int)index;
+#endif
+}
+
+/***************************************************
+ * POP LSB
+ * Remove the lowest square from the set and return it
+ ***************************************************/
+inline int popLsb(Bitboard & bb)
+{
+   int location = lsb(bb);
+   bb &= bb - 1;
+   return location;
+}
+
+/***************************************************
+ * PEXT
+ * Gather the squares of a set that fall under a mask into
+ * the low bits, in order. This is one BMI2 instruction, so
+ * it is only here on 64-bit x86, and only to be called once
+ * the processor has said it has BMI2 (see magic.h). The
+ * instruction is written out by hand on GCC and Clang so the
+ * rest of the program need not be built for BMI2
+ ***************************************************/
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define BITBOARD_HAS_PEXT
+inline uint64_t pext(Bitboard bb, Bitboard mask)
+{
+   uint64_t result;
+   __asm__("pextq %2, %1, %0" : "=r"(result) : "r"(bb), "r"(mask));
+   return result;
+}
+#elif defined(_MSC_VER) && defined(_M_X64)
+#define BITBOARD_HAS_PEXT
+inline uint64_t pext(Bitboard bb, Bitboard mask)
+{
+   return _pext_u64(bb, mask);
+}
+#endif
+
+/***************************************************
+ * SHIFTS
+ * Move every square in the set one step in a direction,
+ * dropping the squares that fall off the edge of the board
+ ***************************************************/
+constexpr Bitboard shiftNorth(Bitboard bb) { return bb << 8;             }
+constexpr Bitboard shiftSouth(Bitboard bb) { return bb >> 8;             }
+constexpr Bitboard shiftEast (Bitboard bb) { return (bb << 1) & ~FILE_A; }
+constexpr Bitboard shiftWest (Bitboard bb) { return (bb >> 1) & ~FILE_H; }
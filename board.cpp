@@ -8,13 +8,48 @@
  ************************************************************************/
 
 #include "board.h"
+#include "attacks.h"
+#include "zobrist.h"
 #include "uiDraw.h"
 #include "position.h"
 #include "pieceSpace.h"
+#include "transposition.h"
+#include "pieceType.h" // for PIECE_VALUES
+#include <algorithm>   // for find() and max()
 #include <cassert>
+#include <cstdio>      // for snprintf()
+#include <cstdlib>     // for abs()
 #include <iostream>
+#include <utility>     // for swap()
 using namespace std;
 
+/***********************************************
+ * CASTLE MASK
+ *         The castling rights that survive a move
+ *         from or to a given square. Moving the king
+ *         or a rook, or capturing a rook, loses them.
+ ***********************************************/
+static int castleMask(int location)
+{
+   switch (location)
+   {
+      case 0:     // a1
+         return CASTLE_ALL & ~CASTLE_WHITE_QUEEN;
+      case 4:     // e1
+         return CASTLE_ALL & ~(CASTLE_WHITE_KING | CASTLE_WHITE_QUEEN);
+      case 7:     // h1
+         return CASTLE_ALL & ~CASTLE_WHITE_KING;
+      case 56:    // a8
+         return CASTLE_ALL & ~CASTLE_BLACK_QUEEN;
+      case 60:    // e8
+         return CASTLE_ALL & ~(CASTLE_BLACK_KING | CASTLE_BLACK_QUEEN);
+      case 63:    // h8
+         return CASTLE_ALL & ~CASTLE_BLACK_KING;
+      default:
+         return CASTLE_ALL;
+   }
+}
+
 
 /***********************************************
  * BOARD : RESET
@@ -35,48 +70,57 @@ using namespace std;
 void Board::reset(bool fFree)
 {
    if (fFree) free();
-   for (int r = 0; r < 8; r++)
+   numMoves      = 0;
+   castling      = CASTLE_ALL;
+   enPassant     = -1;
+   halfmoveClock = 0;
+   numUndo       = 0;
+
+   // one object per square: the pieces below fill the first and last two rows
+   for (int r = 2; r < 6; r++)
    {
        for (int c = 0; c < 8; c++) {
-           board[c][r] = new Space(c, r);
+           board[c][r] = pool.acquire(SPACE, c, r, true);
        }
    }
    
    // White pieces
-   board[0][0] = new Rook(0, 0, true);  // White Rook
-   board[7][0] = new Rook(7, 0, true);  // White Rook
-   board[1][0] = new Knight(1, 0, true);  // White Knight
-   board[6][0] = new Knight(6, 0, true);  // White Knight
-   board[2][0] = new Bishop(2, 0, true);  // White Rook
-   board[5][0] = new Bishop(5, 0, true);  // White Rook
-   board[3][0] = new Queen(3, 0, true);  // White Queen
-   board[4][0] = new King(4, 0, true);  // White King
-   board[0][1] = new Pawn(0, 1, true);  // White Pawn
-   board[1][1] = new Pawn(1, 1, true);  // White Pawn
-   board[2][1] = new Pawn(2, 1, true);  // White Pawn
-   board[3][1] = new Pawn(3, 1, true);  // White Pawn
-   board[4][1] = new Pawn(4, 1, true);  // White Pawn
-   board[5][1] = new Pawn(5, 1, true);  // White Pawn
-   board[6][1] = new Pawn(6, 1, true);  // White Pawn
-   board[7][1] = new Pawn(7, 1, true);  // White Pawn
+   board[0][0] = pool.acquire(ROOK, 0, 0, true);  // White Rook
+   board[7][0] = pool.acquire(ROOK, 7, 0, true);  // White Rook
+   board[1][0] = pool.acquire(KNIGHT, 1, 0, true);  // White Knight
+   board[6][0] = pool.acquire(KNIGHT, 6, 0, true);  // White Knight
+   board[2][0] = pool.acquire(BISHOP, 2, 0, true);  // White Rook
+   board[5][0] = pool.acquire(BISHOP, 5, 0, true);  // White Rook
+   board[3][0] = pool.acquire(QUEEN, 3, 0, true);  // White Queen
+   board[4][0] = pool.acquire(KING, 4, 0, true);  // White King
+   board[0][1] = pool.acquire(PAWN, 0, 1, true);  // White Pawn
+   board[1][1] = pool.acquire(PAWN, 1, 1, true);  // White Pawn
+   board[2][1] = pool.acquire(PAWN, 2, 1, true);  // White Pawn
+   board[3][1] = pool.acquire(PAWN, 3, 1, true);  // White Pawn
+   board[4][1] = pool.acquire(PAWN, 4, 1, true);  // White Pawn
+   board[5][1] = pool.acquire(PAWN, 5, 1, true);  // White Pawn
+   board[6][1] = pool.acquire(PAWN, 6, 1, true);  // White Pawn
+   board[7][1] = pool.acquire(PAWN, 7, 1, true);  // White Pawn
 
    // Black pieces
-   board[0][7] = new Rook(0, 7, false);    // Black Rook
-   board[7][7] = new Rook(7, 7, false);    // Black Rook
-   board[1][7] = new Knight(1, 7, false);  // Black Knight
-   board[6][7] = new Knight(6, 7, false);  // Black Knight
-   board[2][7] = new Bishop(2, 7, false);  // Black Rook
-   board[5][7] = new Bishop(5, 7, false);  // Black Rook
-   board[3][7] = new Queen(3, 7, false);   // Black Queen
-   board[4][7] = new King(4, 7, false);    // Black King
-   board[0][6] = new Pawn(0, 6, false);    // Black Pawn
-   board[1][6] = new Pawn(1, 6, false);    // Black Pawn
-   board[2][6] = new Pawn(2, 6, false);    // Black Pawn
-   board[3][6] = new Pawn(3, 6, false);    // Black Pawn
-   board[4][6] = new Pawn(4, 6, false);    // Black Pawn
-   board[5][6] = new Pawn(5, 6, false);    // Black Pawn
-   board[6][6] = new Pawn(6, 6, false);    // Black Pawn
-   board[7][6] = new Pawn(7, 6, false);    // Black Pawn
+   board[0][7] = pool.acquire(ROOK, 0, 7, false);    // Black Rook
+   board[7][7] = pool.acquire(ROOK, 7, 7, false);    // Black Rook
+   board[1][7] = pool.acquire(KNIGHT, 1, 7, false);  // Black Knight
+   board[6][7] = pool.acquire(KNIGHT, 6, 7, false);  // Black Knight
+   board[2][7] = pool.acquire(BISHOP, 2, 7, false);  // Black Rook
+   board[5][7] = pool.acquire(BISHOP, 5, 7, false);  // Black Rook
+   board[3][7] = pool.acquire(QUEEN, 3, 7, false);   // Black Queen
+   board[4][7] = pool.acquire(KING, 4, 7, false);    // Black King
+   board[0][6] = pool.acquire(PAWN, 0, 6, false);    // Black Pawn
+   board[1][6] = pool.acquire(PAWN, 1, 6, false);    // Black Pawn
+   board[2][6] = pool.acquire(PAWN, 2, 6, false);    // Black Pawn
+   board[3][6] = pool.acquire(PAWN, 3, 6, false);    // Black Pawn
+   board[4][6] = pool.acquire(PAWN, 4, 6, false);    // Black Pawn
+   board[5][6] = pool.acquire(PAWN, 5, 6, false);    // Black Pawn
+   board[6][6] = pool.acquire(PAWN, 6, 6, false);    // Black Pawn
+   board[7][6] = pool.acquire(PAWN, 7, 6, false);    // Black Pawn
+
+   syncBitboards();
 }
 
 /***********************************************
@@ -96,19 +140,28 @@ Piece& Board::operator [] (const Position& pos)
 
  /***********************************************
  * BOARD : DISPLAY
- *         Display the board
+ *         Display the board. Each square is drawn
+ *         from its code, as Piece::display() would
  ***********************************************/
 void Board::display(const Position & posHover, const Position & posSelect) const
 {
    pgout->drawHover(posHover);
    pgout->drawSelected(posSelect);
    pgout->drawBoard();
-   for (int r = 0; r < 8; r++)
+   for (int location = 0; location < 64; location++)
    {
-       for (int c = 0; c < 8; c++)
-       {
-          board[c][r]->display(pgout);
-       }
+      Position pos(location);
+      bool isWhite = isWhiteCode(squares[location]);
+      switch (typeOf(squares[location]))
+      {
+         case KING:   pgout->drawKing  (pos, isWhite); break;
+         case QUEEN:  pgout->drawQueen (pos, isWhite); break;
+         case ROOK:   pgout->drawRook  (pos, isWhite); break;
+         case BISHOP: pgout->drawBishop(pos, isWhite); break;
+         case KNIGHT: pgout->drawKnight(pos, isWhite); break;
+         case PAWN:   pgout->drawPawn  (pos, isWhite); break;
+         default:                                      break;
+      }
    }
 }
 
@@ -117,67 +170,228 @@ void Board::display(const Position & posHover, const Position & posSelect) const
  * BOARD : CONSTRUCT
  *         Free up all the allocated memory
  ************************************************/
-Board::Board(ogstream* pgout, bool noreset) : pgout(pgout), numMoves(0)
+Board::Board(ogstream* pgout, bool noreset) : numUndo(0), pPrefetch(nullptr), pgout(pgout)
 {
+   numMoves      = 0;
+   castling      = CASTLE_NONE;
+   enPassant     = -1;
+   halfmoveClock = 0;
+   for (int r = 0; r < 8; r++)
+      for (int c = 0; c < 8; c++)
+         board[c][r] = nullptr;
+   clearBitboards();
    if (!noreset)
       reset();
 }
 
 
+/************************************************
+ * BOARD : COPY CONSTRUCTOR
+ *         Every copy gets pieces of its own so two
+ *         boards never share (or free) the same Piece.
+ *         This is how each perft thread gets its board
+ ************************************************/
+Board::Board(const Board & rhs) : BoardSnapshot(rhs),
+   numUndo(rhs.numUndo), pPrefetch(rhs.pPrefetch), pgout(rhs.pgout)
+{
+   for (int i = 0; i < numUndo; i++)
+      undoStack[i] = rhs.undoStack[i];
+   for (int location = 0; location < 64; location++)
+      squares[location] = rhs.squares[location];
+
+   for (int r = 0; r < 8; r++)
+      for (int c = 0; c < 8; c++)
+      {
+         const Piece * pRhs = rhs.board[c][r];
+         Piece * pCopy = nullptr;
+         if (pRhs != nullptr)
+         {
+            PieceType pt = pRhs->getType();
+            pCopy = pool.acquire(pt < KING || pt > PAWN ? SPACE : pt, c, r, pRhs->isWhite());
+            *pCopy = *pRhs;   // the move count and last move come along too
+         }
+         board[c][r] = pCopy;
+      }
+}
+
+
+/************************************************
+ * BOARD : SNAPSHOT CONSTRUCTOR
+ *         A board for the position in a snapshot,
+ *         with a Piece on every square for the UI.
+ *         Nothing has been made yet, so nothing to undo
+ ************************************************/
+Board::Board(const BoardSnapshot & snapshot, ogstream* pgout) :
+   BoardSnapshot(snapshot), numUndo(0), pPrefetch(nullptr), pgout(pgout)
+{
+   for (int r = 0; r < 8; r++)
+      for (int c = 0; c < 8; c++)
+         board[c][r] = nullptr;
+   syncSquares();
+   syncPieces();
+}
+
+/************************************************
+ * BOARD : SET SNAPSHOT
+ *         Put back a position taken by getSnapshot().
+ *         The bitboards, state and key come in one copy;
+ *         only the square codes need working out again
+ ************************************************/
+void Board::setSnapshot(const BoardSnapshot & snapshot)
+{
+   static_cast<BoardSnapshot &>(*this) = snapshot;
+   numUndo = 0;
+   syncSquares();
+}
+
+
+/************************************************
+ * BOARD : DESTRUCT
+ *         The board owns every Piece on it
+ ************************************************/
+Board::~Board()
+{
+   for (int r = 0; r < 8; r++)
+      for (int c = 0; c < 8; c++)
+         delete board[c][r];
+}
+
 /************************************************
  * BOARD : FREE
- *         Free up all the allocated memory
+ *         Give every piece back to the pool
  ************************************************/
 void Board::free()
 {
    for (int r = 0; r < 8; r++)
       for (int c = 0; c < 8; c++)
       {
-         // delete board[c][r];
+         pool.release(board[c][r]);
          board[c][r] = nullptr;
       }
 }
 
 
+/************************************************
+ * BOARD : CLEAR BITBOARDS
+ *         Empty every bitboard
+ ************************************************/
+void Board::clearBitboards()
+{
+   for (int pt = 0; pt < 8; pt++)
+      bbType[pt] = EMPTY_BB;
+   bbColor[0] = bbColor[1] = EMPTY_BB;
+   for (int location = 0; location < 64; location++)
+      squares[location] = NO_PIECE;
+   key = computeKey();
+}
+
+/************************************************
+ * BOARD : SYNC SQUARE
+ *         Make the bitboards agree with the piece
+ *         sitting on one square of the board
+ ************************************************/
+void Board::syncSquare(const Position& pos)
+{
+   int location = pos.getLocation();
+   PieceCode old = squares[location];
+   if (typeOf(old) != SPACE)
+      key ^= ZOBRIST.pieces[isWhiteCode(old) ? 0 : 1][typeOf(old)][location];
+   squares[location] = NO_PIECE;
+
+   Bitboard mask = ~squareBit(location);
+   for (int pt = KING; pt <= PAWN; pt++)
+      bbType[pt] &= mask;
+   bbColor[0] &= mask;
+   bbColor[1] &= mask;
+
+   const Piece* piece = board[pos.getCol()][pos.getRow()];
+   if (piece == nullptr)
+      return;
+   PieceType pt = piece->getType();
+   if (pt < KING || pt > PAWN)
+      return;
+   int c = piece->isWhite() ? 0 : 1;
+   bbType[pt] |= squareBit(location);
+   bbColor[c] |= squareBit(location);
+   squares[location] = pieceCode(pt, c == 0);
+   key ^= ZOBRIST.pieces[c][pt][location];
+}
+
+/************************************************
+ * BOARD : SYNC SQUARES
+ *         Rebuild the square codes from the bitboards
+ ************************************************/
+void Board::syncSquares()
+{
+   for (int location = 0; location < 64; location++)
+      squares[location] = NO_PIECE;
+   for (int pt = KING; pt <= PAWN; pt++)
+      for (Bitboard pieces = bbType[pt]; pieces; )
+      {
+         int location = popLsb(pieces);
+         squares[location] = pieceCode((PieceType)pt, (bbColor[0] & squareBit(location)) != 0);
+      }
+}
+
+/************************************************
+ * BOARD : SYNC PIECES
+ *         Make the Piece objects agree with the square
+ *         codes. A piece already right stays put, so
+ *         loading a similar position swaps only a few
+ ************************************************/
+void Board::syncPieces()
+{
+   for (int location = 0; location < 64; location++)
+   {
+      int c = colOf(location);
+      int r = rowOf(location);
+      PieceCode code = squares[location];
+      Piece * pPiece = board[c][r];
+      if (pPiece != nullptr && pPiece->getType() == typeOf(code) &&
+          (typeOf(code) == SPACE || pPiece->isWhite() == isWhiteCode(code)))
+         continue;
+      pool.release(pPiece);
+      board[c][r] = pool.acquire(typeOf(code), c, r, isWhiteCode(code));
+   }
+}
+
+/************************************************
+ * BOARD : SYNC BITBOARDS
+ *         Rebuild every bitboard from the pieces on
+ *         the board. Needed after the board is filled by hand
+ ************************************************/
+void Board::syncBitboards()
+{
+   clearBitboards();
+   for (int location = 0; location < 64; location++)
+      syncSquare(Position(location));
+}
+
 /**********************************************
  * BOARD : IS CHECKED
- *         Verify if a king is checked
+ *         Verify if a king is checked. This reads
+ *         the bitboards; no moves are generated
  *********************************************/
 bool Board::isChecked(set<Move>& moves, bool isWhiteTurn)
 {
-    // Get the position of the current player's king
-    Position kingPosition;
-
-    // Find the king's position on the board
-    for (int c = 0; c < 8; c++) {
-        for (int r = 0; r < 8; r++) {
-            Piece* piece = board[c][r];
-            if (piece && piece->getType() == KING && piece->isWhite() == isWhiteTurn) {
-                kingPosition = Position(c, r);
-                break;
-            }
-        }
-    }
+    return isChecked(isWhiteTurn);
+}
 
-    // Check all pieces for potential moves
-    for (int c = 0; c < 8; c++) {
-        for (int r = 0; r < 8; r++) {
-            Piece* piece = board[c][r];
-            if (piece && piece->isWhite() != isWhiteTurn) { // Check only opponent's pieces
-                set<Move> opponentMoves;
-                piece->getMoves(opponentMoves, *this);
-                
-                // Check if any opponent's move can reach the King's position
-                for (const Move& move : opponentMoves) {
-                    if (move.getTo() == kingPosition) {
-                        return true; // The king is in check
-                    }
-                }
-            }
-        }
-    }
+bool Board::isChecked(bool isWhiteTurn) const
+{
+    return isKingAttacked(isWhiteTurn);
+}
 
-    return false; // The king is not in check
+/**********************************************
+ * BOARD : GET MOVES
+ *         Every move of the side whose turn it is.
+ *         The moves come from the bitboards, a switch
+ *         on the piece type choosing the attacks, so no
+ *         Piece is asked and nothing touches the heap
+ *********************************************/
+void Board::getMoves(MoveList& moves) const
+{
+    generateMoves(moves);
 }
 
 /**********************************************
@@ -188,10 +402,13 @@ void Board::undo(Move move)
 {
    Position source = move.getFrom();
    Position dest = move.getTo();
+   bool wasWhite = (numMoves % 2 == 0);
+   int oldCastling = castling;
+   int oldEnPassant = enPassant;
 
    if (board[source.getCol()][source.getRow()] != nullptr)
    {
-       delete board[source.getCol()][source.getRow()]; // Delete the piece at the source
+       pool.release(board[source.getCol()][source.getRow()]); // Give back the piece at the source
    }
    
    // Move the piece back to its source position
@@ -199,45 +416,54 @@ void Board::undo(Move move)
    movingPiece->setPosition(source);
    board[source.getCol()][source.getRow()] = movingPiece;
 
-   // Restore any captured piece at the destination
+   // Restore any captured piece at the destination: it belonged to the other side
    PieceType capturedType = move.getCapturedPieceType();
-   bool isWhite = movingPiece->isWhite();
+   bool isWhite = !movingPiece->isWhite();
 
-   // Recreate the captured piece in its original position
-   switch (capturedType)
+   // Recreate the captured piece in its original position. En passant
+   // took a pawn beside the source, not on the destination
+   if (move.getMoveType() == Move::ENPASSANT)
    {
-      case KING:
-         board[dest.getCol()][dest.getRow()] = new King(dest.getCol(), dest.getRow(), isWhite);
-         break;
-         
-      case QUEEN:
-         board[dest.getCol()][dest.getRow()] = new Queen(dest.getCol(), dest.getRow(), isWhite);
-         break;
-      
-      case BISHOP:
-         board[dest.getCol()][dest.getRow()] = new Bishop(dest.getCol(), dest.getRow(), isWhite);
-         break;
-         
-      case KNIGHT:
-         board[dest.getCol()][dest.getRow()] = new Knight(dest.getCol(), dest.getRow(), isWhite);
-         break;
-         
-      case ROOK:
-         board[dest.getCol()][dest.getRow()] = new Rook(dest.getCol(), dest.getRow(), isWhite);
-         break;
-         
-      case PAWN:
-         board[dest.getCol()][dest.getRow()] = new Pawn(dest.getCol(), dest.getRow(), isWhite);
-         break;
-         
-      default:
-         board[dest.getCol()][dest.getRow()] = new Space(dest.getCol(), dest.getRow());
-         break;
+      Position captured(dest.getCol(), source.getRow());
+      pool.release(board[captured.getCol()][captured.getRow()]);
+      board[captured.getCol()][captured.getRow()] =
+         pool.acquire(PAWN, captured.getCol(), captured.getRow(), isWhite);
+      syncSquare(captured);
+      capturedType = SPACE;
+   }
+   board[dest.getCol()][dest.getRow()] = (capturedType >= KING && capturedType <= PAWN) ?
+      pool.acquire(capturedType, dest.getCol(), dest.getRow(), isWhite) :
+      pool.acquire(SPACE, dest.getCol(), dest.getRow(), true);
+
+   // A castle takes the rook back to its corner too
+   if (movingPiece->getType() == KING && abs(dest.getCol() - source.getCol()) == 2)
+   {
+      int row = source.getRow();
+      Position rookFrom(dest.getCol() > source.getCol() ? 7 : 0, row);
+      Position rookTo((source.getCol() + dest.getCol()) / 2, row);
+      std::swap(board[rookFrom.getCol()][row], board[rookTo.getCol()][row]);
+      board[rookFrom.getCol()][row]->setPosition(rookFrom);
+      board[rookTo.getCol()][row]->setPosition(rookTo);
+      syncSquare(rookFrom);
+      syncSquare(rookTo);
    }
    
    // When undo is called, it means that a move has already been performed (meaning numMoves increments),
    // so it is neccessary to decrement numMoves to reflect the undo
    numMoves --;
+
+   syncSquare(source);
+   syncSquare(dest);
+
+   // Put back the game state move() remembered
+   if (numUndo > 0)
+   {
+      const UndoRecord & record = undoStack[--numUndo];
+      castling      = record.castling;
+      enPassant     = record.enPassant;
+      halfmoveClock = record.halfmoveClock;
+   }
+   updateStateKey(wasWhite, oldCastling, oldEnPassant);
 }
 
 
@@ -253,6 +479,18 @@ void Board::move(Move & move)       // Take moves as a parameter so the boad can
     // Get source and destination positions for clarity
     Position source = move.getFrom();
     Position dest = move.getTo();
+    bool wasWhite = (numMoves % 2 == 0);
+    int oldCastling = castling;
+    int oldEnPassant = enPassant;
+
+    // Remember the game state so undo() can put it back
+    PieceType movingType = board[source.getCol()][source.getRow()]->getType();
+    bool isCapture = move.getMoveType() == Move::ENPASSANT ||
+        (board[dest.getCol()][dest.getRow()]->getType() != SPACE &&
+         board[dest.getCol()][dest.getRow()]->isWhite() != board[source.getCol()][source.getRow()]->isWhite());
+    PieceType capturedType = !isCapture ? SPACE :
+        move.getMoveType() == Move::ENPASSANT ? PAWN : board[dest.getCol()][dest.getRow()]->getType();
+    pushUndo(PackedMove(move), capturedType);
 
     // Handle captures
     if (board[dest.getCol()][dest.getRow()]->getType() != SPACE)
@@ -260,14 +498,14 @@ void Board::move(Move & move)       // Take moves as a parameter so the boad can
         // If it's not a castling move, handle as capture
         if (board[source.getCol()][source.getRow()]->getType() != KING)
         {
-            delete board[dest.getCol()][dest.getRow()];
-            board[dest.getCol()][dest.getRow()] = new Space(dest.getCol(), dest.getRow());
+            pool.release(board[dest.getCol()][dest.getRow()]);
+            board[dest.getCol()][dest.getRow()] = pool.acquire(SPACE, dest.getCol(), dest.getRow(), true);
         }
         else if (board[source.getCol()][source.getRow()]->isWhite() !=
             board[dest.getCol()][dest.getRow()]->isWhite())
         {
-            delete board[dest.getCol()][dest.getRow()];
-            board[dest.getCol()][dest.getRow()] = new Space(dest.getCol(), dest.getRow());
+            pool.release(board[dest.getCol()][dest.getRow()]);
+            board[dest.getCol()][dest.getRow()] = pool.acquire(SPACE, dest.getCol(), dest.getRow(), true);
         }
     }
 
@@ -288,26 +526,36 @@ void Board::move(Move & move)       // Take moves as a parameter so the boad can
            int capturedRow = movingPiece->isWhite() ? dest.getRow() - 1 : dest.getRow() + 1;
 
            // Remove the captured pawn from the board
-           delete board[dest.getCol()][capturedRow];
-           board[dest.getCol()][capturedRow] = new Space(dest.getCol(), capturedRow);
+           pool.release(board[dest.getCol()][capturedRow]);
+           board[dest.getCol()][capturedRow] = pool.acquire(SPACE, dest.getCol(), capturedRow, true);
+           syncSquare(Position(dest.getCol(), capturedRow));
        }
-       else
+       else if (dest.getRow() == (movingPiece->isWhite() ? 7 : 0))
        {
-          // White pawn promotion
-          if (dest.getRow() == 7 && movingPiece->isWhite())
-          {
-             delete board[dest.getCol()][dest.getRow()];
-             board[dest.getCol()][dest.getRow()] = new Queen(dest.getCol(), dest.getRow(), true);
-          }
-          // Black pawn promotion
-          else if (dest.getRow() == 0 && !movingPiece->isWhite())
-          {
-             delete board[dest.getCol()][dest.getRow()];
-             board[dest.getCol()][dest.getRow()] = new Queen(dest.getCol(), dest.getRow(), false);
-          }
+          // Pawn promotion: to the piece the move names, a queen if it names none
+          PieceType promote = move.getPromotionPieceType();
+          if (promote != ROOK && promote != BISHOP && promote != KNIGHT)
+             promote = QUEEN;
+          bool isWhitePawn = movingPiece->isWhite();
+          pool.release(board[dest.getCol()][dest.getRow()]);
+          board[dest.getCol()][dest.getRow()] = pool.acquire(promote, dest.getCol(), dest.getRow(), isWhitePawn);
        }
     }
 
+    // A castle carries the rook over the king in the same move
+    if (movingPiece->getType() == KING && abs(dest.getCol() - source.getCol()) == 2)
+    {
+       int row = source.getRow();
+       Position rookFrom(dest.getCol() > source.getCol() ? 7 : 0, row);
+       Position rookTo((source.getCol() + dest.getCol()) / 2, row);
+       std::swap(board[rookFrom.getCol()][row], board[rookTo.getCol()][row]);
+       board[rookTo.getCol()][row]->setPosition(rookTo);
+       board[rookTo.getCol()][row]->setLastMove(numMoves);
+       board[rookFrom.getCol()][row]->setPosition(rookFrom);
+       syncSquare(rookFrom);
+       syncSquare(rookTo);
+    }
+
     // Update piece positions
     if (board[dest.getCol()][dest.getRow()]->getType() != SPACE)
     {
@@ -317,20 +565,26 @@ void Board::move(Move & move)       // Take moves as a parameter so the boad can
     if (board[source.getCol()][source.getRow()]->getType() != SPACE)
         board[source.getCol()][source.getRow()]->setPosition(source);
 
+    // Keep the bitboards in step with the pieces
+    syncSquare(source);
+    syncSquare(dest);
+
     // Update move counters
     board[dest.getCol()][dest.getRow()]->setLastMove(numMoves);
     board[source.getCol()][source.getRow()]->setLastMove(numMoves);
 
     // Increment the move counter
     numMoves++;
-   
-    // Adjust if castle
-   if (((source.getCol() ==  4 && source.getRow() == 0) ||
-       (source.getCol() ==  4 && source.getRow() == 7)) &&
-       abs(source.getCol() - dest.getCol()) == 2)
-   {
-      numMoves --;
-   }
+
+    // Update the castling rights, en-passant square and halfmove clock
+    castling &= castleMask(source.getLocation()) & castleMask(dest.getLocation());
+    enPassant = (movingType == PAWN && abs(dest.getRow() - source.getRow()) == 2) ?
+        squareOf(dest.getCol(), (source.getRow() + dest.getRow()) / 2) : -1;
+    halfmoveClock = (movingType == PAWN || isCapture) ? 0 : halfmoveClock + 1;
+
+   updateStateKey(wasWhite, oldCastling, oldEnPassant);
+   if (pPrefetch)
+      pPrefetch->prefetch(key);
 }
 
 
@@ -353,3 +607,977 @@ BoardEmpty::~BoardEmpty()
    delete pSpace;
 }
 
+
+
+/**********************************************
+ * BOARD : ADD / REMOVE / MOVE PIECE
+ *         Change the bitboards and the square
+ *         codes for one piece
+ *********************************************/
+void Board::addPiece(int c, PieceType pt, int location)
+{
+   bbType[pt] |= squareBit(location);
+   bbColor[c] |= squareBit(location);
+   squares[location] = pieceCode(pt, c == 0);
+   key ^= ZOBRIST.pieces[c][pt][location];
+}
+
+void Board::removePiece(int c, PieceType pt, int location)
+{
+   bbType[pt] &= ~squareBit(location);
+   bbColor[c] &= ~squareBit(location);
+   squares[location] = NO_PIECE;
+   key ^= ZOBRIST.pieces[c][pt][location];
+}
+
+void Board::movePiece(int c, PieceType pt, int from, int to)
+{
+   Bitboard fromTo = squareBit(from) | squareBit(to);
+   bbType[pt] ^= fromTo;
+   bbColor[c] ^= fromTo;
+   squares[to]   = squares[from];
+   squares[from] = NO_PIECE;
+   key ^= ZOBRIST.pieces[c][pt][from] ^ ZOBRIST.pieces[c][pt][to];
+}
+
+/**********************************************
+ * BOARD : PUSH UNDO
+ *         Remember what a move is about to destroy
+ *********************************************/
+void Board::pushUndo(const PackedMove & move, PieceType capture)
+{
+   assert(numUndo < MAX_UNDO);
+   UndoRecord & record   = undoStack[numUndo++];
+   record.move           = move;
+   record.capture        = (uint8_t)capture;
+   record.castling       = (uint8_t)castling;
+   record.enPassant      = (int8_t)enPassant;
+   record.halfmoveClock  = (uint16_t)halfmoveClock;
+}
+
+/**********************************************
+ * BOARD : MAKE MOVE
+ *         Play a move on the bitboards. Nothing is
+ *         allocated; the undo stack remembers enough
+ *         for unmakeMove() to restore the exact position
+ *   INPUT move  A move for the side whose turn it is
+ *********************************************/
+void Board::makeMove(const PackedMove & move)
+{
+   int from = move.getFrom();
+   int to   = move.getTo();
+   int us   = whiteTurn() ? 0 : 1;
+   int them = 1 - us;
+   int oldCastling = castling;
+   int oldEnPassant = enPassant;
+   PieceType pt = getPieceType(from);
+   assert(pt != SPACE);
+   assert(bbColor[us] & squareBit(from));
+
+   // what is captured, and where is it?
+   PieceType capture = SPACE;
+   int captureSquare = to;
+   if (move.isEnPassant())
+   {
+      capture = PAWN;
+      captureSquare = (us == 0) ? to - 8 : to + 8;
+   }
+   else if (bbColor[them] & squareBit(to))
+      capture = getPieceType(to);
+
+   pushUndo(move, capture);
+
+   if (capture != SPACE)
+      removePiece(them, capture, captureSquare);
+   movePiece(us, pt, from, to);
+
+   // a promoted pawn becomes a new piece, a castling king brings the rook
+   if (move.isPromotion())
+   {
+      removePiece(us, PAWN, to);
+      addPiece(us, move.getPromotion(), to);
+   }
+   else if (move.getFlag() == PackedMove::CASTLE_KING)
+      movePiece(us, ROOK, from + 3, from + 1);
+   else if (move.getFlag() == PackedMove::CASTLE_QUEEN)
+      movePiece(us, ROOK, from - 4, from - 1);
+
+   castling &= castleMask(from) & castleMask(to);
+   enPassant = (pt == PAWN && (to - from == 16 || from - to == 16)) ? (from + to) / 2 : -1;
+   halfmoveClock = (pt == PAWN || capture != SPACE) ? 0 : halfmoveClock + 1;
+   numMoves++;
+   updateStateKey(us == 0, oldCastling, oldEnPassant);
+   if (pPrefetch)
+      pPrefetch->prefetch(key);
+}
+
+/**********************************************
+ * BOARD : UNMAKE MOVE
+ *         Take back the last makeMove(), restoring
+ *         the exact prior position and game state
+ *********************************************/
+void Board::unmakeMove()
+{
+   assert(numUndo > 0);
+   const UndoRecord & record = undoStack[--numUndo];
+   numMoves--;
+
+   const PackedMove & move = record.move;
+   int from = move.getFrom();
+   int to   = move.getTo();
+   int us   = whiteTurn() ? 0 : 1;
+   int them = 1 - us;
+
+   // put the piece back where it came from
+   if (move.isPromotion())
+   {
+      removePiece(us, move.getPromotion(), to);
+      addPiece(us, PAWN, from);
+   }
+   else
+   {
+      movePiece(us, getPieceType(to), to, from);
+      if (move.getFlag() == PackedMove::CASTLE_KING)
+         movePiece(us, ROOK, from + 1, from + 3);
+      else if (move.getFlag() == PackedMove::CASTLE_QUEEN)
+         movePiece(us, ROOK, from - 1, from - 4);
+   }
+
+   // bring back whatever was captured
+   if (record.capture != SPACE)
+   {
+      int captureSquare = to;
+      if (move.isEnPassant())
+         captureSquare = (us == 0) ? to - 8 : to + 8;
+      addPiece(them, (PieceType)record.capture, captureSquare);
+   }
+
+   int oldCastling  = castling;
+   int oldEnPassant = enPassant;
+   castling      = record.castling;
+   enPassant     = record.enPassant;
+   halfmoveClock = record.halfmoveClock;
+   updateStateKey(us != 0, oldCastling, oldEnPassant);
+}
+
+/**********************************************
+ * BOARD : IS SQUARE ATTACKED
+ *         Could a piece of the given color capture
+ *         on this square? Look outward from the square
+ *         with each kind of piece and see what it finds.
+ *         A ray is only walked when a slider is on its line
+ *********************************************/
+bool Board::isSquareAttacked(int location, bool byWhite) const
+{
+   Bitboard them = getColor(byWhite);
+
+   if (pawnAttacks(location, !byWhite) & bbType[PAWN] & them)
+      return true;
+   if (knightAttacks(location) & bbType[KNIGHT] & them)
+      return true;
+   if (kingAttacks(location) & bbType[KING] & them)
+      return true;
+
+   Bitboard diagonal = (bbType[BISHOP] | bbType[QUEEN]) & them;
+   Bitboard straight = (bbType[ROOK]   | bbType[QUEEN]) & them;
+   if (!(ATTACKS.bishopRays[location] & diagonal) && !(ATTACKS.rookRays[location] & straight))
+      return false;
+
+   Bitboard occupied = getOccupied();
+   if ((ATTACKS.bishopRays[location] & diagonal) && (bishopAttacks(location, occupied) & diagonal))
+      return true;
+   if ((ATTACKS.rookRays[location] & straight) && (rookAttacks(location, occupied) & straight))
+      return true;
+   return false;
+}
+
+/**********************************************
+ * BOARD : IS KING ATTACKED
+ *         Is the king of the given color attacked?
+ *         Unlike isChecked(), this only reads the bitboards
+ *********************************************/
+bool Board::isKingAttacked(bool isWhite) const
+{
+   Bitboard king = getPieces(KING, isWhite);
+   return king && isSquareAttacked(lsb(king), !isWhite);
+}
+
+/**********************************************
+ * BOARD : ATTACKERS TO
+ *         Every piece of the given color that attacks
+ *         a square, as if the board held only occupied
+ *   INPUT occupied  The pieces that block the sliders
+ *********************************************/
+Bitboard Board::attackersTo(int location, bool byWhite, Bitboard occupied) const
+{
+   return ((pawnAttacks(location, !byWhite)      & bbType[PAWN])                       |
+           (knightAttacks(location)              & bbType[KNIGHT])                     |
+           (kingAttacks(location)                & bbType[KING])                       |
+           (bishopAttacks(location, occupied)    & (bbType[BISHOP] | bbType[QUEEN]))   |
+           (rookAttacks(location, occupied)      & (bbType[ROOK]   | bbType[QUEEN])))  &
+          getColor(byWhite);
+}
+
+/**********************************************
+ * BOARD : SEE VALUE
+ *         What a move takes outright, and what the
+ *         piece that lands on the square is worth
+ *********************************************/
+static int seeCaptured(const Board & board, const PackedMove & move)
+{
+   int value = move.isEnPassant() ? PIECE_VALUES[PAWN] :
+               move.isCapture()   ? PIECE_VALUES[board.getPieceType(move.getTo())] : 0;
+   if (move.isPromotion())
+      value += PIECE_VALUES[move.getPromotion()] - PIECE_VALUES[PAWN];
+   return value;
+}
+
+static PieceType seeLanded(const Board & board, const PackedMove & move)
+{
+   return move.isPromotion() ? move.getPromotion() : board.getPieceType(move.getFrom());
+}
+
+/**********************************************
+ * BOARD : SEE OCCUPIED
+ *         The pieces left on the board once the move
+ *         is made, an en passant victim included
+ *********************************************/
+Bitboard Board::seeOccupied(const PackedMove & move) const
+{
+   Bitboard occupied = (getOccupied() ^ squareBit(move.getFrom())) | squareBit(move.getTo());
+   if (move.isEnPassant())
+      occupied ^= squareBit(squareOf(colOf(move.getTo()), rowOf(move.getFrom())));
+   return occupied;
+}
+
+/**********************************************
+ * BOARD : SEE RECAPTURE
+ *         The least valuable of the attackers takes
+ *         next. It leaves occupied, and a slider that
+ *         stood behind it joins the attackers
+ *   INPUT   attackers  Of both colors, still to capture
+ *   OUTPUT  occupied   Without the piece that captures
+ *           return     Its type, or SPACE if side has none
+ *********************************************/
+PieceType Board::seeRecapture(int to, bool side, Bitboard & attackers, Bitboard & occupied) const
+{
+   Bitboard mine = attackers & getColor(side);
+   for (int pt = PAWN; pt >= KING; pt--)
+   {
+      Bitboard pieces = mine & bbType[pt];
+      if (!pieces)
+         continue;
+
+      occupied ^= squareBit(lsb(pieces));
+      if (pt == PAWN || pt == BISHOP || pt == QUEEN)
+         attackers |= bishopAttacks(to, occupied) & (bbType[BISHOP] | bbType[QUEEN]);
+      if (pt == ROOK || pt == QUEEN)
+         attackers |= rookAttacks(to, occupied) & (bbType[ROOK] | bbType[QUEEN]);
+      attackers &= occupied;
+      return (PieceType)pt;
+   }
+   return SPACE;
+}
+
+/**********************************************
+ * BOARD : SEE
+ *         The material the side to move comes out with
+ *         if both sides keep capturing on the move's
+ *         square, least valuable piece first, and each
+ *         stops as soon as going on would lose more. Only
+ *         the bitboards are read: a capture is a bit
+ *         taken out of occupied, which uncovers any
+ *         slider behind it. Pins are not considered, and
+ *         the king only captures onto an undefended square
+ *********************************************/
+int Board::see(const PackedMove & move) const
+{
+   if (move.isCastle())
+      return 0;
+
+   int to = move.getTo();
+   Bitboard occupied  = seeOccupied(move);
+   Bitboard attackers = (attackersTo(to, true, occupied) | attackersTo(to, false, occupied)) & occupied;
+   bool side = (getColor(true) & squareBit(move.getFrom())) == EMPTY_BB;
+   PieceType onSquare = seeLanded(*this, move);
+
+   // gain[d] is what the side making the d-th capture wins, if it
+   // is the last one
+   int gain[32];
+   int d = 0;
+   gain[0] = seeCaptured(*this, move);
+   while (d < 31)
+   {
+      if (!(attackers & getColor(side)))
+         break;
+      if ((attackers & getColor(side) & ~bbType[KING]) == EMPTY_BB &&
+          (attackers & getColor(!side)))
+         break;
+      d++;
+      gain[d] = PIECE_VALUES[onSquare] - gain[d - 1];
+      onSquare = seeRecapture(to, side, attackers, occupied);
+      side = !side;
+   }
+
+   // either side may stop instead of capturing
+   for (; d > 0; d--)
+      gain[d - 1] = -max(-gain[d - 1], gain[d]);
+   return gain[0];
+}
+
+/**********************************************
+ * BOARD : SEE GE
+ *         Is see(move) at least threshold? The answer
+ *         is often known before the exchange is over:
+ *         once the side to capture is ahead of the
+ *         threshold even after losing the piece it
+ *         captures with, the rest cannot change it
+ *********************************************/
+bool Board::seeGE(const PackedMove & move, int threshold) const
+{
+   if (move.isCastle())
+      return 0 >= threshold;
+
+   // what the move wins over the threshold, then what is
+   // left if the piece that moved is taken back
+   int balance = seeCaptured(*this, move) - threshold;
+   if (balance < 0)
+      return false;
+   balance = PIECE_VALUES[seeLanded(*this, move)] - balance;
+   if (balance <= 0)
+      return true;
+
+   int to = move.getTo();
+   Bitboard occupied  = seeOccupied(move);
+   Bitboard attackers = (attackersTo(to, true, occupied) | attackersTo(to, false, occupied)) & occupied;
+   bool side = (getColor(true) & squareBit(move.getFrom())) != EMPTY_BB;
+   bool isGood = true;
+   for (;;)
+   {
+      side = !side;
+      if (!(attackers & getColor(side)))
+         break;
+      isGood = !isGood;
+      PieceType pt = seeRecapture(to, side, attackers, occupied);
+      if (pt == KING)
+         return (attackers & getColor(!side)) ? !isGood : isGood;
+      balance = PIECE_VALUES[pt] - balance;
+      if (balance < (isGood ? 1 : 0))
+         break;
+   }
+   return isGood;
+}
+
+/**********************************************
+ * BOARD : GEN TARGETS
+ *         The squares a piece other than a pawn may
+ *         move to: the opponents for the captures,
+ *         the empty squares for the rest
+ *********************************************/
+Bitboard Board::genTargets(GenType type) const
+{
+   Bitboard targets = EMPTY_BB;
+   if (type & GEN_CAPTURES)
+      targets |= getColor(!whiteTurn());
+   if (type & GEN_QUIETS)
+      targets |= ~getOccupied();
+   return targets;
+}
+
+/**********************************************
+ * BOARD : GENERATE MOVES
+ *         All the pseudo-legal moves for the side to
+ *         move, read from the bitboards alone
+ *   INPUT  type   All the moves, or only the captures
+ *                 and promotions, or only the rest
+ *   OUTPUT moves  Every move is appended to this list
+ *********************************************/
+void Board::generateMoves(MoveList & moves, GenType type) const
+{
+   bool isWhite = whiteTurn();
+   Bitboard opponents = getColor(!isWhite);
+   Bitboard targetMask = genTargets(type);
+
+   generatePawnMoves (moves, type, ~EMPTY_BB, ~EMPTY_BB, EMPTY_BB, -1);
+   generatePieceMoves(moves, ~EMPTY_BB, targetMask, EMPTY_BB, -1);
+
+   for (Bitboard kings = getPieces(KING, isWhite); kings; )
+   {
+      int from = popLsb(kings);
+      for (Bitboard targets = kingAttacks(from) & targetMask; targets; )
+      {
+         int to = popLsb(targets);
+         moves.add(PackedMove(from, to, (opponents & squareBit(to)) ?
+                              PackedMove::CAPTURE : PackedMove::QUIET));
+      }
+   }
+
+   if (type & GEN_QUIETS)
+      generateCastles(moves);
+}
+
+/**********************************************
+ * BOARD : GENERATE LEGAL MOVES
+ *         Only the moves that do not leave our own king
+ *         attacked, without making any of them:
+ *         - the king may not step onto a square attacked
+ *           once it has left its own square
+ *         - in double check, only the king may move
+ *         - in check, the others must capture the checker
+ *           or step between it and the king (checkMask)
+ *         - a pinned piece may only move along its pin
+ *   INPUT  type   All the moves, or only the captures
+ *                 and promotions, or only the rest
+ *   OUTPUT moves  Every legal move is appended to this list
+ *********************************************/
+void Board::generateLegalMoves(MoveList & moves, GenType type) const
+{
+   generateLegal(moves, type, ~EMPTY_BB);
+}
+
+/**********************************************
+ * BOARD : IS LEGAL
+ *         Is this one of the legal moves here? Only
+ *         the moves of the piece on its source square
+ *         are generated, and only of its kind, so a
+ *         move remembered from elsewhere in the search
+ *         can be checked before it is tried
+ *********************************************/
+bool Board::isLegal(const PackedMove & move) const
+{
+   if (move.isNull() || !(getColor(whiteTurn()) & squareBit(move.getFrom())))
+      return false;
+   MoveList moves;
+   generateLegal(moves, (move.isCapture() || move.isPromotion()) ? GEN_CAPTURES : GEN_QUIETS,
+                 squareBit(move.getFrom()));
+   return std::find(moves.begin(), moves.end(), move) != moves.end();
+}
+
+/**********************************************
+ * BOARD : GENERATE LEGAL
+ *         generateLegalMoves() for the pieces on fromMask
+ *********************************************/
+void Board::generateLegal(MoveList & moves, GenType type, Bitboard fromMask) const
+{
+   bool isWhite = whiteTurn();
+   Bitboard kingBB = getPieces(KING, isWhite);
+   if (!kingBB)
+   {
+      // nothing to leave in check, so every move is legal
+      MoveList all;
+      generateMoves(all, type);
+      for (const PackedMove & move : all)
+         if (fromMask & squareBit(move.getFrom()))
+            moves.add(move);
+      return;
+   }
+
+   int king = lsb(kingBB);
+   Bitboard own       = getColor(isWhite);
+   Bitboard opponents = getColor(!isWhite);
+   Bitboard occupied  = own | opponents;
+   Bitboard checkers  = attackersTo(king, !isWhite, occupied);
+   Bitboard targetMask = genTargets(type);
+
+   // the king cannot hide from a slider by stepping back along its ray
+   Bitboard kingTargets = (fromMask & kingBB) ? kingAttacks(king) & targetMask : EMPTY_BB;
+   for (Bitboard targets = kingTargets; targets; )
+   {
+      int to = popLsb(targets);
+      if (!attackersTo(to, !isWhite, occupied ^ kingBB))
+         moves.add(PackedMove(king, to, (opponents & squareBit(to)) ?
+                              PackedMove::CAPTURE : PackedMove::QUIET));
+   }
+
+   if (popCount(checkers) > 1)
+      return;
+
+   Bitboard checkMask = ~EMPTY_BB;
+   if (checkers)
+      checkMask = checkers | ATTACKS.between[king][lsb(checkers)];
+
+   Bitboard pinned = getPinned(king, isWhite);
+   generatePawnMoves (moves, type, fromMask, checkMask, pinned, king);
+   generatePieceMoves(moves, fromMask, checkMask & targetMask, pinned, king);
+   if (!checkers && (type & GEN_QUIETS) && (fromMask & kingBB))
+      generateCastles(moves);
+}
+
+/**********************************************
+ * BOARD : GET PINNED
+ *         Our pieces that are the only thing standing
+ *         between our king and an opponent's slider
+ *********************************************/
+Bitboard Board::getPinned(int king, bool isWhite) const
+{
+   Bitboard snipers = ((ATTACKS.rookRays[king]   & (bbType[ROOK]   | bbType[QUEEN])) |
+                       (ATTACKS.bishopRays[king] & (bbType[BISHOP] | bbType[QUEEN]))) &
+                      getColor(!isWhite);
+   Bitboard occupied = getOccupied();
+   Bitboard pinned = EMPTY_BB;
+   while (snipers)
+   {
+      Bitboard blockers = ATTACKS.between[king][popLsb(snipers)] & occupied;
+      if (blockers && !(blockers & (blockers - 1)))
+         pinned |= blockers & getColor(isWhite);
+   }
+   return pinned;
+}
+
+/**********************************************
+ * BOARD : GENERATE PIECE MOVES
+ *         The queens, rooks, bishops and knights
+ *   INPUT fromMask    Squares of the pieces to move
+ *         targetMask  Squares a move may land on: out of
+ *                     check, and of the kind asked for
+ *         pinned      Pieces that must stay on the line to the king
+ *         king        Our king's square, -1 when nothing is pinned
+ *********************************************/
+void Board::generatePieceMoves(MoveList & moves, Bitboard fromMask, Bitboard targetMask,
+                               Bitboard pinned, int king) const
+{
+   bool isWhite = whiteTurn();
+   Bitboard own       = getColor(isWhite);
+   Bitboard opponents = getColor(!isWhite);
+   Bitboard occupied  = own | opponents;
+
+   for (int pt = QUEEN; pt <= KNIGHT; pt++)
+      for (Bitboard pieces = getPieces((PieceType)pt, isWhite) & fromMask; pieces; )
+      {
+         int from = popLsb(pieces);
+         Bitboard targets;
+         switch (pt)
+         {
+            case QUEEN:  targets = queenAttacks(from, occupied);  break;
+            case ROOK:   targets = rookAttacks(from, occupied);   break;
+            case BISHOP: targets = bishopAttacks(from, occupied); break;
+            default:     targets = knightAttacks(from);           break;
+         }
+         targets &= ~own & targetMask;
+         if (pinned & squareBit(from))
+            targets &= ATTACKS.line[king][from];
+         while (targets)
+         {
+            int to = popLsb(targets);
+            moves.add(PackedMove(from, to, (opponents & squareBit(to)) ?
+                                 PackedMove::CAPTURE : PackedMove::QUIET));
+         }
+      }
+}
+
+/**********************************************
+ * BOARD : GENERATE PAWN MOVES
+ *         Pushes, double pushes, captures, en passant
+ *         and the four promotions. A promotion counts
+ *         with the captures, even a push
+ *   INPUT type       The captures, the rest, or both
+ *         fromMask   Squares of the pawns to move
+ *         checkMask  Squares a move may land on
+ *         pinned     Pawns that must stay on the line to the king
+ *         king       Our king's square, -1 for pseudo-legal moves
+ *********************************************/
+void Board::generatePawnMoves(MoveList & moves, GenType type, Bitboard fromMask,
+                              Bitboard checkMask, Bitboard pinned, int king) const
+{
+   bool isWhite = whiteTurn();
+   Bitboard opponents = getColor(!isWhite);
+   Bitboard empty     = ~getOccupied();
+   Bitboard lastRank  = isWhite ? RANK_8 : RANK_1;
+   Bitboard startRank = isWhite ? RANK_2 : RANK_7;
+   int forward        = isWhite ? 8 : -8;
+
+   for (Bitboard pawns = getPieces(PAWN, isWhite) & fromMask; pawns; )
+   {
+      int from = popLsb(pawns);
+      Bitboard allowed = checkMask;
+      if (pinned & squareBit(from))
+         allowed &= ATTACKS.line[king][from];
+
+      // a push is a quiet move unless it promotes
+      Bitboard targets = (type & GEN_CAPTURES) ? pawnAttacks(from, isWhite) & opponents : EMPTY_BB;
+      int to = from + forward;
+      if ((empty & squareBit(to)) &&
+          (type & ((lastRank & squareBit(to)) ? GEN_CAPTURES : GEN_QUIETS)))
+      {
+         targets |= squareBit(to);
+         if ((startRank & squareBit(from)) && (empty & allowed & squareBit(to + forward)))
+            moves.add(PackedMove(from, to + forward));
+      }
+
+      for (targets &= allowed; targets; )
+      {
+         to = popLsb(targets);
+         bool isCapture = (opponents & squareBit(to)) != 0;
+         if (lastRank & squareBit(to))
+         {
+            moves.add(PackedMove(from, to, PackedMove::promoteFlag(QUEEN,  isCapture)));
+            moves.add(PackedMove(from, to, PackedMove::promoteFlag(ROOK,   isCapture)));
+            moves.add(PackedMove(from, to, PackedMove::promoteFlag(BISHOP, isCapture)));
+            moves.add(PackedMove(from, to, PackedMove::promoteFlag(KNIGHT, isCapture)));
+         }
+         else
+            moves.add(PackedMove(from, to, isCapture ? PackedMove::CAPTURE : PackedMove::QUIET));
+      }
+
+      if ((type & GEN_CAPTURES) && enPassant >= 0 &&
+          (pawnAttacks(from, isWhite) & squareBit(enPassant)) &&
+          (king < 0 || isEnPassantLegal(from, king)))
+         moves.add(PackedMove(from, enPassant, PackedMove::ENPASSANT));
+   }
+}
+
+/**********************************************
+ * BOARD : IS EN PASSANT LEGAL
+ *         En passant takes two pawns off a rank at once,
+ *         which pins cannot describe, so look at the
+ *         board as it would be after the capture
+ *********************************************/
+bool Board::isEnPassantLegal(int from, int king) const
+{
+   bool isWhite = whiteTurn();
+   int captured = isWhite ? enPassant - 8 : enPassant + 8;
+   Bitboard occupied = (getOccupied() ^ squareBit(from) ^ squareBit(captured)) | squareBit(enPassant);
+   Bitboard them = getColor(!isWhite);
+
+   if (attackersTo(king, !isWhite, getOccupied()) & ~squareBit(captured) &
+       ~(bbType[BISHOP] | bbType[ROOK] | bbType[QUEEN]))
+      return false;    // a knight or king check that capturing cannot stop
+   return !(bishopAttacks(king, occupied) & (bbType[BISHOP] | bbType[QUEEN]) & them) &&
+          !(rookAttacks(king, occupied)   & (bbType[ROOK]   | bbType[QUEEN]) & them);
+}
+
+/**********************************************
+ * BOARD : GENERATE CASTLES
+ *         The king may not castle out of, through,
+ *         or into check, and the squares between the
+ *         king and the rook must be empty
+ *********************************************/
+void Board::generateCastles(MoveList & moves) const
+{
+   bool isWhite = whiteTurn();
+   int rightKing  = isWhite ? CASTLE_WHITE_KING  : CASTLE_BLACK_KING;
+   int rightQueen = isWhite ? CASTLE_WHITE_QUEEN : CASTLE_BLACK_QUEEN;
+   if (!(castling & (rightKing | rightQueen)))
+      return;
+
+   int king = isWhite ? 4 : 60;     // e1 or e8
+   Bitboard occupied = getOccupied();
+   if (!(getPieces(KING, isWhite) & squareBit(king)) || isSquareAttacked(king, !isWhite))
+      return;
+
+   Bitboard rooks = getPieces(ROOK, isWhite);
+   if ((castling & rightKing) && (rooks & squareBit(king + 3)) &&
+       !(occupied & (squareBit(king + 1) | squareBit(king + 2))) &&
+       !isSquareAttacked(king + 1, !isWhite) &&
+       !isSquareAttacked(king + 2, !isWhite))
+      moves.add(PackedMove(king, king + 2, PackedMove::CASTLE_KING));
+
+   if ((castling & rightQueen) && (rooks & squareBit(king - 4)) &&
+       !(occupied & (squareBit(king - 1) | squareBit(king - 2) | squareBit(king - 3))) &&
+       !isSquareAttacked(king - 1, !isWhite) &&
+       !isSquareAttacked(king - 2, !isWhite))
+      moves.add(PackedMove(king, king - 2, PackedMove::CASTLE_QUEEN));
+}
+
+/**********************************************
+ * BOARD : COMPUTE KEY
+ *         The Zobrist key worked out from scratch.
+ *         The key kept by the moves should always match
+ *********************************************/
+uint64_t Board::computeKey() const
+{
+   uint64_t k = 0;
+   for (int c = 0; c < 2; c++)
+      for (int pt = KING; pt <= PAWN; pt++)
+         for (Bitboard pieces = bbType[pt] & bbColor[c]; pieces; )
+            k ^= ZOBRIST.pieces[c][pt][popLsb(pieces)];
+   k ^= ZOBRIST.castling[castling];
+   if (enPassant >= 0)
+      k ^= ZOBRIST.enPassant[colOf(enPassant)];
+   if (numMoves % 2 != 0)    // not whiteTurn(): the test doubles assert on it
+      k ^= ZOBRIST.blackToMove;
+   return k;
+}
+
+/**********************************************
+ * BOARD : UPDATE STATE KEY
+ *         Fold a change of side to move, castling
+ *         rights or en-passant square into the key
+ *   INPUT wasWhite      Whose turn it was before
+ *         oldCastling   The castling rights before
+ *         oldEnPassant  The en-passant square before
+ *********************************************/
+void Board::updateStateKey(bool wasWhite, int oldCastling, int oldEnPassant)
+{
+   if (wasWhite != (numMoves % 2 == 0))
+      key ^= ZOBRIST.blackToMove;
+   key ^= ZOBRIST.castling[oldCastling] ^ ZOBRIST.castling[castling];
+   if (oldEnPassant >= 0)
+      key ^= ZOBRIST.enPassant[colOf(oldEnPassant)];
+   if (enPassant >= 0)
+      key ^= ZOBRIST.enPassant[colOf(enPassant)];
+}
+
+/**********************************************
+ * FEN LETTERS
+ *         The FEN letter of each PieceType, white.
+ *         Black is the same letter in lower case
+ *********************************************/
+static const char FEN_LETTERS[] = "??KQRBNP";
+
+/**********************************************
+ * PARSE CLOCK
+ *         Read a clock field: digits only, and no
+ *         more than maxValue
+ *********************************************/
+static bool parseClock(std::string_view field, int & value, int maxValue)
+{
+   if (field.empty() || field.size() > 6)
+      return false;
+   value = 0;
+   for (char ch : field)
+   {
+      if (ch < '0' || ch > '9')
+         return false;
+      value = value * 10 + (ch - '0');
+   }
+   return value <= maxValue;
+}
+
+/**********************************************
+ * HALFMOVE MAX
+ *         The largest halfmove clock a FEN may give.
+ *         The undo records keep the clock in 16 bits,
+ *         and it must still fit after a full stack
+ *         of moves with no capture or pawn move
+ *********************************************/
+static const int HALFMOVE_MAX = 0xffff - Board::MAX_UNDO;
+static const int FULLMOVE_MAX = 999999;
+
+/**********************************************
+ * NEXT FIELD
+ *         The next run of text between spaces, with
+ *         fen advanced past it
+ *********************************************/
+static std::string_view nextField(std::string_view & fen)
+{
+   size_t begin = fen.find_first_not_of(' ');
+   if (begin == std::string_view::npos)
+   {
+      fen = std::string_view();
+      return fen;
+   }
+   size_t end = fen.find(' ', begin);
+   if (end == std::string_view::npos)
+      end = fen.size();
+   std::string_view field = fen.substr(begin, end - begin);
+   fen.remove_prefix(end);
+   return field;
+}
+
+/**********************************************
+ * BOARD : LOAD FEN
+ *         Read the position into a snapshot, checking
+ *         every field, and only copy it in if the whole
+ *         text made sense. Nothing is allocated: the
+ *         Piece objects come from the pool
+ *   INPUT fen  "placement side castling en-passant
+ *               [halfmove fullmove]"
+ *********************************************/
+bool Board::loadFEN(std::string_view fen)
+{
+   BoardSnapshot snapshot = {};
+   snapshot.enPassant = -1;
+
+   // placement: rank 8 first, files a through h
+   std::string_view placement = nextField(fen);
+   int col = 0;
+   int row = 7;
+   for (char ch : placement)
+   {
+      if (ch == '/')
+      {
+         if (col != 8 || row == 0)
+            return false;
+         row--;
+         col = 0;
+      }
+      else if (ch >= '1' && ch <= '8')
+      {
+         col += ch - '0';
+         if (col > 8)
+            return false;
+      }
+      else
+      {
+         PieceType pt = SPACE;
+         switch (ch | 0x20)
+         {
+            case 'k': pt = KING;   break;
+            case 'q': pt = QUEEN;  break;
+            case 'r': pt = ROOK;   break;
+            case 'b': pt = BISHOP; break;
+            case 'n': pt = KNIGHT; break;
+            case 'p': pt = PAWN;   break;
+            default:  return false;
+         }
+         if (col > 7)
+            return false;
+         int c = (ch & 0x20) ? 1 : 0;
+         Bitboard bit = squareBit(squareOf(col, row));
+         snapshot.bbType[pt] |= bit;
+         snapshot.bbColor[c] |= bit;
+         col++;
+      }
+   }
+   if (row != 0 || col != 8)
+      return false;
+
+   // the move generator needs one king a side, and no pawn on the back ranks
+   for (int c = 0; c < 2; c++)
+   {
+      Bitboard kings = snapshot.bbType[KING] & snapshot.bbColor[c];
+      if (kings == EMPTY_BB || (kings & (kings - 1)))
+         return false;
+   }
+   if (snapshot.bbType[PAWN] & (RANK_1 | RANK_8))
+      return false;
+
+   // side to move
+   std::string_view side = nextField(fen);
+   if (side != "w" && side != "b")
+      return false;
+   bool isWhite = side == "w";
+
+   // castling
+   std::string_view rights = nextField(fen);
+   if (rights.empty())
+      return false;
+   if (rights != "-")
+      for (char ch : rights)
+         switch (ch)
+         {
+            case 'K': snapshot.castling |= CASTLE_WHITE_KING;  break;
+            case 'Q': snapshot.castling |= CASTLE_WHITE_QUEEN; break;
+            case 'k': snapshot.castling |= CASTLE_BLACK_KING;  break;
+            case 'q': snapshot.castling |= CASTLE_BLACK_QUEEN; break;
+            default:  return false;
+         }
+
+   // a right is only kept while its king and rook are at home. A piece
+   // missing from a home square loses the rights castleMask() says it would
+   const struct { int location; PieceType pt; int c; } homes[] =
+   {
+      { 4, KING, 0 }, { 0, ROOK, 0 }, { 7, ROOK, 0 },
+      { 60, KING, 1 }, { 56, ROOK, 1 }, { 63, ROOK, 1 }
+   };
+   for (const auto & home : homes)
+      if (!(snapshot.bbType[home.pt] & snapshot.bbColor[home.c] & squareBit(home.location)) &&
+          (snapshot.castling & ~castleMask(home.location)))
+         return false;
+
+   // the side that just moved cannot have left its king in check
+   int king = lsb(snapshot.bbType[KING] & snapshot.bbColor[isWhite ? 1 : 0]);
+   Bitboard occupied = snapshot.bbColor[0] | snapshot.bbColor[1];
+   if (((pawnAttacks(king, !isWhite)     & snapshot.bbType[PAWN])                                |
+        (knightAttacks(king)             & snapshot.bbType[KNIGHT])                              |
+        (kingAttacks(king)               & snapshot.bbType[KING])                                |
+        (bishopAttacks(king, occupied)   & (snapshot.bbType[BISHOP] | snapshot.bbType[QUEEN]))   |
+        (rookAttacks(king, occupied)     & (snapshot.bbType[ROOK]   | snapshot.bbType[QUEEN])))  &
+       snapshot.bbColor[isWhite ? 0 : 1])
+      return false;
+
+   // en passant: the square behind a pawn that just moved two
+   std::string_view passant = nextField(fen);
+   if (passant.empty())
+      return false;
+   if (passant != "-")
+   {
+      if (passant.size() != 2 || passant[0] < 'a' || passant[0] > 'h' ||
+          passant[1] != (isWhite ? '6' : '3'))
+         return false;
+      snapshot.enPassant = squareOf(passant[0] - 'a', passant[1] - '1');
+
+      // the pawn that just moved two stands past the square, and both
+      // the square and the one it started from are empty
+      int pushed = snapshot.enPassant + (isWhite ? -8 : 8);
+      int started = snapshot.enPassant + (isWhite ? 8 : -8);
+      if (!(snapshot.bbType[PAWN] & snapshot.bbColor[isWhite ? 1 : 0] & squareBit(pushed)) ||
+          (occupied & (squareBit(snapshot.enPassant) | squareBit(started))))
+         return false;
+   }
+
+   // the clocks, if they are there
+   int fullmove = 1;
+   std::string_view halfmove = nextField(fen);
+   if (!halfmove.empty())
+   {
+      if (!parseClock(halfmove, snapshot.halfmoveClock, HALFMOVE_MAX) ||
+          !parseClock(nextField(fen), fullmove, FULLMOVE_MAX) ||
+          !nextField(fen).empty())
+         return false;
+      if (fullmove < 1)
+         fullmove = 1;
+   }
+   snapshot.numMoves = (fullmove - 1) * 2 + (isWhite ? 0 : 1);
+
+   setSnapshot(snapshot);
+   key = computeKey();
+   syncPieces();
+   return true;
+}
+
+/**********************************************
+ * BOARD : TO FEN
+ *         All six fields, read off the square codes
+ *********************************************/
+std::string Board::toFEN() const
+{
+   char text[96];     // the longest FEN is well under this
+   char * p = text;
+
+   for (int row = 7; row >= 0; row--)
+   {
+      int empty = 0;
+      for (int col = 0; col < 8; col++)
+      {
+         PieceCode code = squares[squareOf(col, row)];
+         if (typeOf(code) == SPACE)
+         {
+            empty++;
+            continue;
+         }
+         if (empty)
+            *p++ = (char)('0' + empty);
+         empty = 0;
+         char letter = FEN_LETTERS[typeOf(code)];
+         *p++ = isWhiteCode(code) ? letter : (char)(letter | 0x20);
+      }
+      if (empty)
+         *p++ = (char)('0' + empty);
+      if (row)
+         *p++ = '/';
+   }
+
+   *p++ = ' ';
+   *p++ = (numMoves % 2 == 0) ? 'w' : 'b';
+
+   *p++ = ' ';
+   if (castling & CASTLE_WHITE_KING)  *p++ = 'K';
+   if (castling & CASTLE_WHITE_QUEEN) *p++ = 'Q';
+   if (castling & CASTLE_BLACK_KING)  *p++ = 'k';
+   if (castling & CASTLE_BLACK_QUEEN) *p++ = 'q';
+   if (!(castling & CASTLE_ALL))      *p++ = '-';
+
+   *p++ = ' ';
+   if (enPassant >= 0)
+   {
+      *p++ = (char)('a' + colOf(enPassant));
+      *p++ = (char)('1' + rowOf(enPassant));
+   }
+   else
+      *p++ = '-';
+
+   p += snprintf(p, text + sizeof(text) - p, " %d %d", halfmoveClock, numMoves / 2 + 1);
+   return std::string(text, p);
+}
@@ -11,7 +11,12 @@
 
 #include <stack>
 #include <cassert>
+#include <type_traits>
+#include <string>
+#include <string_view>
 #include "move.h"   // Because we return a set of Move
+#include "moveList.h" // Because we fill a MoveList
+#include "bitboard.h" // Because the position is stored as bitboards
 #include "piece.h"  // Because BoardEmpty need to know the fill definition
 #include "pieceQueen.h"
 #include "pieceKnight.h"
@@ -20,6 +25,7 @@
 #include "pieceKing.h"
 #include "piecePawn.h"
 #include "pieceSpace.h"
+#include "piecePool.h" // Because the board recycles its pieces
 
 class ogstream;
 class TestPawn;
@@ -29,16 +35,84 @@ class TestRook;
 class TestQueen;
 class TestKing;
 class TestBoard;
+class TestMoveList;
+class TestPerft;
 class Position;
 class Piece;
+class TranspositionTable;
 
 
+/***************************************************
+ * CASTLE RIGHT
+ * Which castles are still allowed, one bit each
+ **************************************************/
+enum CastleRight
+{
+   CASTLE_NONE        = 0,
+   CASTLE_WHITE_KING  = 1,
+   CASTLE_WHITE_QUEEN = 2,
+   CASTLE_BLACK_KING  = 4,
+   CASTLE_BLACK_QUEEN = 8,
+   CASTLE_ALL         = 15
+};
+
+/***************************************************
+ * GEN TYPE
+ * Which moves a generator produces. The quiescence
+ * search only wants the ones that change the material
+ **************************************************/
+enum GenType
+{
+   GEN_CAPTURES = 1,   // captures, en passant, and every promotion
+   GEN_QUIETS   = 2,   // everything else, castling included
+   GEN_ALL      = 3
+};
+
+/***************************************************
+ * UNDO RECORD
+ * Everything a move destroys that unmakeMove()
+ * cannot work out from the move itself
+ **************************************************/
+struct UndoRecord
+{
+   PackedMove move;           // the move that was made
+   uint8_t    capture;        // PieceType that was captured, SPACE if none
+   uint8_t    castling;       // CastleRight bits before the move
+   int8_t     enPassant;      // en-passant square before the move, -1 if none
+   uint16_t   halfmoveClock;  // halfmove clock before the move
+};
+
+
+/***************************************************
+ * BOARD SNAPSHOT
+ * Everything that makes up a position in one flat block:
+ * the bitboards, whose turn it is, the game state and the
+ * key. It holds no pointers, so it copies with a single
+ * memcpy. A Board is built on one, which is how copy-make
+ * saves and restores a position in one assignment
+ **************************************************/
+struct BoardSnapshot
+{
+   Bitboard bbType[8];      // [PieceType] squares of each kind of piece, both colors
+   Bitboard bbColor[2];     // [white, black] squares occupied by each side
+   uint64_t key;            // Zobrist key of everything here
+   int numMoves;            // plies played; even when it is white's turn
+   int castling;            // CastleRight bits still available
+   int enPassant;           // square a pawn may capture onto en-passant, -1 if none
+   int halfmoveClock;       // plies since the last capture or pawn move
+};
+
+static_assert(std::is_trivially_copyable<BoardSnapshot>::value,
+              "a snapshot must copy with memcpy");
+static_assert(sizeof(BoardSnapshot) < 128,
+              "a snapshot must stay within two cache lines");
+
 
 /***************************************************
  * BOARD
  * The game board
  **************************************************/
-class Board
+class Board : protected BoardSnapshot
 {
    friend TestPawn;
    friend TestKnight;
@@ -47,17 +121,24 @@ class Board
    friend TestQueen;
    friend TestKing;
    friend TestBoard;
+   friend TestMoveList;
+   friend TestPerft;
 public:
 
    // create and destroy the board
    Board(ogstream* pgout = nullptr, bool noreset = false);
-   virtual ~Board()   {  }
+   Board(const Board & rhs);
+   Board(const BoardSnapshot & snapshot, ogstream* pgout = nullptr);
+   virtual ~Board();
+   Board & operator = (const Board & rhs) = delete;
 
    // getters
    virtual int  getCurrentMove() const { return numMoves; }
    virtual bool whiteTurn()      const { return numMoves % 2 == 0; }
    virtual void display(const Position& posHover, const Position& posSelect) const;
    virtual bool isChecked(set<Move>& moves, bool isWhiteTurn);
+   virtual bool isChecked(bool isWhiteTurn) const;
+   virtual void getMoves(MoveList& moves) const;
    virtual void undo(Move move);
    virtual const Piece& operator [] (const Position& pos) const;
 
@@ -66,13 +147,100 @@ public:
    virtual void reset(bool fFree = true);
    virtual void move(Move & move);
    virtual Piece& operator [] (const Position& pos);
-    
+
+   // bitboards: the set of squares holding each kind of piece
+   Bitboard getPieces(PieceType pt, bool isWhite) const { return bbType[pt] & bbColor[isWhite ? 0 : 1]; }
+   Bitboard getColor(bool isWhite)                const { return bbColor[isWhite ? 0 : 1];      }
+   Bitboard getOccupied()                         const { return bbColor[0] | bbColor[1];       }
+   virtual Bitboard getPieceOccupancy()           const { return getOccupied();                 }
+   PieceCode getPieceCode(int location)           const { return squares[location];             }
+   PieceType getPieceType(int location)           const { return typeOf(squares[location]);     }
+   void syncBitboards();
+
+   // where the Piece objects come from and go back to
+   const PiecePool & getPool() const { return pool; }
+
+   // game state that is not on the squares
+   int  getCastling()      const { return castling;      }
+   int  getEnPassant()     const { return enPassant;     }
+   int  getHalfmoveClock() const { return halfmoveClock; }
+
+   // the Zobrist key of the position, kept up to date by every move
+   uint64_t getKey()       const { return key;           }
+   uint64_t computeKey()   const;
+
+   // make and unmake: fast moves that only change the bitboards and the
+   // game state. The pieces drawn by the UI are left alone, so pair every
+   // makeMove() with an unmakeMove() before displaying or using operator[]
+   static const int MAX_UNDO = 1024;
+   void makeMove(const PackedMove & move);
+   void unmakeMove();
+   int  getUndoDepth() const { return numUndo; }
+
+   // once a move has been made its key is known, so the table the search
+   // is about to probe can start loading the entry. Null for no table
+   void setPrefetch(const TranspositionTable * pTable) { pPrefetch = pTable; }
+
+   // FEN: load a position, or write this one out. loadFEN() returns
+   // false and leaves the board alone if the text is not a legal FEN.
+   // The clocks may be left off, as they are in EPD
+   bool loadFEN(std::string_view fen);
+   std::string toFEN() const;
+
+   // copy-make: take the whole position in one copy and put it back
+   // in another, instead of unmaking. Like makeMove(), setSnapshot()
+   // leaves the pieces drawn by the UI alone and forgets the undo stack
+   BoardSnapshot getSnapshot() const { return *this; }
+   void setSnapshot(const BoardSnapshot & snapshot);
+
+   // move generation straight from the bitboards. generateMoves() is
+   // pseudo-legal: make each move and reject it if isKingAttacked().
+   // generateLegalMoves() produces only the legal moves. Either can be
+   // limited to the captures and promotions, or to the rest
+   void generateMoves(MoveList & moves, GenType type = GEN_ALL) const;
+   void generateLegalMoves(MoveList & moves, GenType type = GEN_ALL) const;
+   bool isLegal(const PackedMove & move) const;
+   bool isSquareAttacked(int location, bool byWhite) const;
+   bool isKingAttacked(bool isWhite) const;
+   Bitboard attackersTo(int location, bool byWhite, Bitboard occupied) const;
+
+   // static exchange evaluation: what the side to move wins by the
+   // move and the captures that follow on its square, in centipawns.
+   // seeGE() only asks whether that is at least threshold, and often
+   // knows before the exchange is done
+   int  see(const PackedMove & move) const;
+   bool seeGE(const PackedMove & move, int threshold) const;
 
 protected:
    void  assertBoard();
+   void  clearBitboards();
+   void  syncSquare(const Position& pos);
+   void  syncSquares();
+   void  syncPieces();
+   void  addPiece   (int c, PieceType pt, int location);
+   void  removePiece(int c, PieceType pt, int location);
+   void  movePiece  (int c, PieceType pt, int from, int to);
+   void  pushUndo(const PackedMove & move, PieceType capture);
+   void  updateStateKey(bool wasWhite, int oldCastling, int oldEnPassant);
+   void  generateLegal     (MoveList & moves, GenType type, Bitboard fromMask) const;
+   void  generatePawnMoves (MoveList & moves, GenType type, Bitboard fromMask, Bitboard checkMask, Bitboard pinned, int king) const;
+   void  generatePieceMoves(MoveList & moves, Bitboard fromMask, Bitboard targetMask, Bitboard pinned, int king) const;
+   Bitboard genTargets(GenType type) const;
+   void  generateCastles   (MoveList & moves) const;
+   bool  isEnPassantLegal  (int from, int king) const;
+   Bitboard getPinned(int king, bool isWhite) const;
+   Bitboard  seeOccupied(const PackedMove & move) const;
+   PieceType seeRecapture(int to, bool side, Bitboard & attackers, Bitboard & occupied) const;
+
+   Piece * board[8][8];    // the Piece objects, for the tests and operator[]
+   PiecePool pool;          // the Piece objects this board is done with
+
+   PieceCode squares[64];   // what is on each square, kept with the bitboards
+
+   UndoRecord undoStack[MAX_UNDO];  // one record per move not yet unmade
+   int numUndo;
 
-   Piece * board[8][8];    // the board of chess pieces
-   int numMoves;
+   const TranspositionTable * pPrefetch;   // warmed after each move, if any
 
    ogstream* pgout;
 };
@@ -86,13 +254,20 @@ class BoardDummy : public Board
 {
    friend TestBoard;
 public:
-   BoardDummy() : Board()
+   BoardDummy() : Board(nullptr, true /*noreset*/)
    {
        for (int r = 0; r < 8; r++)
            for (int c = 0; c < 8; c++)
                board[c][r] = nullptr;
+       clearBitboards();
+   }
+   ~BoardDummy()
+   {
+      // the pieces on a double belong to the test that put them there
+      for (int r = 0; r < 8; r++)
+         for (int c = 0; c < 8; c++)
+            board[c][r] = nullptr;
    }
-   ~BoardDummy() {}
 
    void display(const Position& posHover,
                 const Position& posSelect) const          { assert(false); }
@@ -138,5 +313,15 @@ public:
          return *pSpace;
    }
    int  getCurrentMove() const { return moveNumber; }
+
+   // the tests place pieces on the grid without touching the bitboards
+   Bitboard getPieceOccupancy() const
+   {
+      Bitboard occupied = EMPTY_BB;
+      for (int location = 0; location < 64; location++)
+         if (board[colOf(location)][rowOf(location)])
+            occupied |= squareBit(location);
+      return occupied;
+   }
 };
 
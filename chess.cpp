@@ -13,16 +13,48 @@
 #include "position.h"     // for POSITION
 #include "piece.h"        // for PIECE and company
 #include "board.h"        // for BOARD
+#include "moveList.h"     // for MOVELIST
+#include "search.h"       // for SEARCH
 #include "test.h"
-#include <set>            // for STD::SET
 #include <cassert>        // for ASSERT
 #include <fstream>        // for IFSTREAM
 #include <string>         // for STRING
+#include <vector>         // for VECTOR
 #include <iostream>
 #include <cstdlib>
 using namespace std;
 
 
+/*************************************
+ * GAME
+ * The board, and the computer that plays black
+ **************************************/
+struct Game
+{
+   Game(ogstream * pgout) : board(pgout), limits(0 /*depth*/, 1000 /*milliseconds*/) { }
+
+   Board        board;
+   Search       search;
+   SearchLimits limits;     // how long the computer thinks
+   vector<uint64_t> keys;   // every position before the one on the board
+};
+
+/*************************************
+ * PLAY
+ * Make a legal move on the board, pieces and all.
+ * A castle moves the rook along with the king
+ **************************************/
+void play(Game * pGame, const PackedMove & found)
+{
+   // Remember the position so the computer can see a repetition coming
+   Board * pBoard = &pGame->board;
+   pGame->keys.push_back(pBoard->getKey());
+
+   // Expand the move, noting which piece it captures
+   Move move = found.getMove(found.isEnPassant() ? PAWN : pBoard->getPieceType(found.getTo()));
+   pBoard->move(move);
+}
+
 /*************************************
  * All the interesting work happens here, when
  * I get called back from OpenGL to draw a frame.
@@ -32,7 +64,8 @@ using namespace std;
  **************************************/
 void callBack(Interface *pUI, void * p)
 {
-    Board* pBoard = (Board*)p;
+    Game* pGame = (Game*)p;
+    Board* pBoard = &pGame->board;
     Position posSelect = pUI->getSelectPosition();
     Position posPrevious = pUI->getPreviousPosition();
 
@@ -43,10 +76,10 @@ void callBack(Interface *pUI, void * p)
         if (!posPrevious.isValid())
         {
             // Check if we're selecting our own piece
-            const Piece& piece = (*pBoard)[posSelect];
+            PieceCode piece = pBoard->getPieceCode(posSelect.getLocation());
 
             // If we select an empty space or opponent's piece, clear selection
-            if (piece.getType() == SPACE || piece.isWhite() != pBoard->whiteTurn())
+            if (typeOf(piece) == SPACE || isWhiteCode(piece) != pBoard->whiteTurn())
             {
                 pUI->clearSelectPosition();
             }
@@ -55,50 +88,23 @@ void callBack(Interface *pUI, void * p)
         // If this is our second click (we have a previous position)
         else
         {
-            // Create the move
-            Move move(posPrevious, posSelect);
-            const Piece& sourcePiece = (*pBoard)[posPrevious];
-
-            // Get valid moves for the selected piece
-            set<Move> moves;
-            sourcePiece.getMoves(moves, *pBoard);
-
-            // Check if destination has an opponent's piece
-            const Piece& destPiece = (*pBoard)[posSelect];
-            if (destPiece.getType() != SPACE &&
-                destPiece.isWhite() != sourcePiece.isWhite())
-            {
-                move.setCapture(destPiece.getType());
-            }
+            // Get the legal moves; nothing illegal needs to be taken back
+            MoveList moves;
+            pBoard->generateLegalMoves(moves);
+            const PackedMove* pFound = moves.find(PackedMove(posPrevious, posSelect));
 
             // Try to execute the move if it's valid
-           if (moves.find(move) != moves.end())
+           if (pFound != moves.end())
            {
-              pBoard->move(move);
-              
-              // To handle extra move for rook during castling
-              if (((move.getFrom().getCol() ==  4 && move.getFrom().getRow() == 0) ||
-                  (move.getFrom().getCol() ==  4 && move.getFrom().getRow() == 7)) &&
-                  abs(move.getFrom().getCol() - move.getTo().getCol()) == 2)
-              {
-                 Move tempMove;
-                 for (Move move : moves)
-                 {
-                    if ((move.getFrom().getCol() == 0 && move.getFrom().getRow() == 0 && move.getTo().getCol() == 3 && move.getTo().getRow() == 0) ||
-                        (move.getFrom().getCol() == 7 && move.getFrom().getRow() == 0 && move.getTo().getCol() == 5 && move.getTo().getRow() == 0) ||
-                        (move.getFrom().getCol() == 0 && move.getFrom().getRow() == 7 && move.getTo().getCol() == 3 && move.getTo().getRow() == 7) ||
-                        (move.getFrom().getCol() == 7 && move.getFrom().getRow() == 7 && move.getTo().getCol() == 5 && move.getTo().getRow() == 0)
-                        )
-                       tempMove = move;
-                 }
-                 pBoard->move(tempMove);
-              }
-              
-              // The board counts move even before that move is finished, so the reversed is the right turn
-              if (pBoard->isChecked(moves, !pBoard->whiteTurn()))
-              {
-                 pBoard->undo(move);
+              play(pGame, *pFound);
 
+              // The computer replies. A null move means the game is over
+              if (!pBoard->whiteTurn())
+              {
+                 pGame->search.setGameKeys(pGame->keys);
+                 SearchResult reply = pGame->search.think(*pBoard, pGame->limits);
+                 if (!reply.bestMove.isNull())
+                    play(pGame, reply.bestMove);
               }
            }
 
@@ -135,12 +141,13 @@ int main(int argc, char** argv)
 
    // Initialize the game class
    ogstream* pgout = new ogstream;
-   Board board(pgout);
+   Game* pGame = new Game(pgout);
 
    // set everything into action
-   ui.run(callBack, (void *)(&board));
+   ui.run(callBack, (void *)pGame);
    
    // All done.
+   delete pGame;
    delete pgout;
    return 0;
 }
@@ -0,0 +1,386 @@
+/***********************************************************************
+ * Source File:
+ *    EPD
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    Read a suite of EPD positions and check them on a pool of threads
+ ************************************************************************/
+
+#include "epd.h"
+#include "board.h"
+#include "perft.h"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+using namespace std;
+
+/***************************************************
+ * TRIM
+ * The text without the spaces around it
+ ***************************************************/
+static string_view trim(string_view text)
+{
+   size_t begin = text.find_first_not_of(" \t\r\n");
+   if (begin == string_view::npos)
+      return string_view();
+   size_t end = text.find_last_not_of(" \t\r\n");
+   return text.substr(begin, end - begin + 1);
+}
+
+/***************************************************
+ * NEXT TOKEN
+ * The next run of text between spaces, with text
+ * advanced past it
+ ***************************************************/
+static string_view nextToken(string_view & text)
+{
+   text = trim(text);
+   size_t end = text.find_first_of(" \t");
+   if (end == string_view::npos)
+      end = text.size();
+   string_view token = text.substr(0, end);
+   text.remove_prefix(end);
+   return token;
+}
+
+/***************************************************
+ * UNQUOTE
+ * An operand without the quotes around it
+ ***************************************************/
+static string_view unquote(string_view operand)
+{
+   if (operand.size() >= 2 && operand.front() == '"' && operand.back() == '"')
+      return operand.substr(1, operand.size() - 2);
+   return operand;
+}
+
+/***************************************************
+ * PARSE EPD
+ * The first four fields are the FEN. After them come the
+ * operations, each an opcode and its operands, ended
+ * by a semicolon. Opcodes we do not use are ignored
+ ***************************************************/
+bool parseEpd(string_view line, EpdPosition & position)
+{
+   line = trim(line);
+   if (line.empty() || line.front() == '#')
+      return false;
+
+   position.fen.clear();
+   position.id.clear();
+   position.bestMoves.clear();
+   position.avoidMoves.clear();
+   for (int d = 0; d <= EpdPosition::MAX_DEPTH; d++)
+      position.perft[d] = 0;
+
+   for (int field = 0; field < 4; field++)
+   {
+      string_view token = nextToken(line);
+      if (token.empty() || token.front() == ';')
+         break;
+      if (field)
+         position.fen += ' ';
+      position.fen.append(token.data(), token.size());
+   }
+
+   while (!line.empty())
+   {
+      size_t end = line.find(';');
+      string_view operation = trim(line.substr(0, end));
+      line = (end == string_view::npos) ? string_view() : line.substr(end + 1);
+
+      string_view opcode = nextToken(operation);
+      operation = trim(operation);
+      if (opcode == "id")
+         position.id = string(unquote(operation));
+      else if (opcode == "bm" || opcode == "am")
+      {
+         vector<string> & moves = (opcode == "bm") ? position.bestMoves : position.avoidMoves;
+         for (string_view move = nextToken(operation); !move.empty(); move = nextToken(operation))
+            moves.push_back(string(move));
+      }
+      else if (opcode.size() == 2 && opcode[0] == 'D' &&
+               opcode[1] >= '1' && opcode[1] <= '0' + EpdPosition::MAX_DEPTH)
+      {
+         uint64_t count = 0;
+         for (char ch : nextToken(operation))
+            if (ch >= '0' && ch <= '9')
+               count = count * 10 + (ch - '0');
+         position.perft[opcode[1] - '0'] = count;
+      }
+   }
+   return true;
+}
+
+/***************************************************
+ * PARSE SAN
+ * Work out what the text says, then look for the one
+ * legal move that fits: the piece, the destination, any
+ * promotion, and the file or rank it must come from
+ ***************************************************/
+PackedMove parseSan(const Board & board, string_view san)
+{
+   while (!san.empty() && strchr("+#!?", san.back()))
+      san.remove_suffix(1);
+
+   MoveList moves;
+   board.generateLegalMoves(moves);
+
+   // castling, with letters or zeros
+   if (san == "O-O" || san == "0-0" || san == "O-O-O" || san == "0-0-0")
+   {
+      int flag = (san.size() == 3) ? PackedMove::CASTLE_KING : PackedMove::CASTLE_QUEEN;
+      for (const PackedMove & move : moves)
+         if (move.getFlag() == flag)
+            return move;
+      return PackedMove();
+   }
+
+   // a promotion at the end, "e8=Q" or "e8Q"
+   PieceType promote = SPACE;
+   if (san.size() >= 3 && strchr("QRBN", san.back()))
+   {
+      switch (san.back())
+      {
+         case 'Q': promote = QUEEN;  break;
+         case 'R': promote = ROOK;   break;
+         case 'B': promote = BISHOP; break;
+         default:  promote = KNIGHT; break;
+      }
+      san.remove_suffix(1);
+      if (san.back() == '=')
+         san.remove_suffix(1);
+   }
+
+   // the piece in front, a pawn if there is none
+   PieceType pt = PAWN;
+   if (!san.empty())
+      switch (san.front())
+      {
+         case 'K': pt = KING;   break;
+         case 'Q': pt = QUEEN;  break;
+         case 'R': pt = ROOK;   break;
+         case 'B': pt = BISHOP; break;
+         case 'N': pt = KNIGHT; break;
+         default:               break;
+      }
+   if (pt != PAWN)
+      san.remove_prefix(1);
+
+   // the destination at the back, and whatever is left narrows the source
+   if (san.size() < 2 || san[san.size() - 2] < 'a' || san[san.size() - 2] > 'h' ||
+       san.back() < '1' || san.back() > '8')
+      return PackedMove();
+   int to = squareOf(san[san.size() - 2] - 'a', san.back() - '1');
+   san.remove_suffix(2);
+   int fromCol = -1;
+   int fromRow = -1;
+   for (char ch : san)
+      if (ch >= 'a' && ch <= 'h')
+         fromCol = ch - 'a';
+      else if (ch >= '1' && ch <= '8')
+         fromRow = ch - '1';
+      else if (ch != 'x' && ch != ':')
+         return PackedMove();
+
+   PackedMove found;
+   int numFound = 0;
+   for (const PackedMove & move : moves)
+      if (move.getTo() == to &&
+          board.getPieceType(move.getFrom()) == pt &&
+          (move.isPromotion() ? move.getPromotion() : SPACE) == promote &&
+          (fromCol < 0 || colOf(move.getFrom()) == fromCol) &&
+          (fromRow < 0 || rowOf(move.getFrom()) == fromRow))
+      {
+         found = move;
+         numFound++;
+      }
+   return (numFound == 1) ? found : PackedMove();
+}
+
+/***************************************************
+ * EPD SUITE : READ
+ * Every position in the stream, numbered by line
+ ***************************************************/
+int EpdSuite::read(istream & in)
+{
+   int numRead = 0;
+   int lineNumber = 0;
+   string line;
+   EpdPosition position;
+   while (getline(in, line))
+   {
+      lineNumber++;
+      if (!parseEpd(line, position))
+         continue;
+      position.lineNumber = lineNumber;
+      positions.push_back(position);
+      numRead++;
+   }
+   return numRead;
+}
+
+/***************************************************
+ * EPD SUITE : CHECK
+ * Load one position and count each "Dn" it gives.
+ * Then, if it has a bm or am, search it and see whether
+ * the move chosen is one of the bm and none of the am.
+ * The search is the thread's own, cleared first so the
+ * positions before this one make no difference
+ ***************************************************/
+EpdResult EpdSuite::check(Board & board, Search & search, const EpdPosition & position) const
+{
+   EpdResult result;
+   result.failure = "nothing to check";
+   auto begin = chrono::steady_clock::now();
+
+   if (!board.loadFEN(position.fen))
+   {
+      result.status = EpdResult::FAIL;
+      result.failure = "not a legal FEN: " + position.fen;
+      return result;
+   }
+
+   for (int d = 1; d <= maxDepth && d <= EpdPosition::MAX_DEPTH; d++)
+   {
+      if (position.perft[d] == 0)
+         continue;
+      uint64_t nodes = perft(board, d);
+      result.nodes += nodes;
+      result.status = EpdResult::PASS;
+      if (nodes != position.perft[d])
+      {
+         result.status = EpdResult::FAIL;
+         result.failure = "D" + to_string(d) + " counted " + to_string(nodes) +
+                          ", expected " + to_string(position.perft[d]);
+         break;
+      }
+   }
+   if (result.status != EpdResult::FAIL &&
+       (!position.bestMoves.empty() || !position.avoidMoves.empty()))
+   {
+      search.clear();
+      SearchResult found = search.think(board, searchLimits);
+      result.nodes   += found.nodes;
+      result.bestMove = found.bestMove;
+
+      string unknown;          // a bm or am that names no legal move
+      bool isBest = position.bestMoves.empty();
+      bool isAvoided = false;
+      for (const string & san : position.bestMoves)
+      {
+         PackedMove move = parseSan(board, san);
+         if (move.isNull())
+            unknown = "bm " + san;
+         isBest = isBest || move == found.bestMove;
+      }
+      for (const string & san : position.avoidMoves)
+      {
+         PackedMove move = parseSan(board, san);
+         if (move.isNull())
+            unknown = "am " + san;
+         isAvoided = isAvoided || move == found.bestMove;
+      }
+
+      result.status = (unknown.empty() && isBest && !isAvoided) ? EpdResult::PASS : EpdResult::FAIL;
+      if (!unknown.empty())
+         result.failure = unknown + " is not a legal move";
+      else if (result.status == EpdResult::FAIL)
+         result.failure = "played " + found.bestMove.getLongAlgebraic();
+   }
+   if (result.status == EpdResult::PASS)
+      result.failure.clear();
+
+   result.seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+   return result;
+}
+
+/***************************************************
+ * EPD SUITE : RUN
+ * Each thread loads positions into a board of its own,
+ * and searches them with a Search of its own. Building
+ * a Search allocates its table, so it is done once per
+ * thread rather than once per position
+ ***************************************************/
+void EpdSuite::run(int numThreads)
+{
+   if (numThreads <= 0)
+      numThreads = (int)thread::hardware_concurrency();
+   if (numThreads > (int)positions.size())
+      numThreads = (int)positions.size();
+   if (numThreads < 1)
+      numThreads = 1;
+
+   auto begin = chrono::steady_clock::now();
+   results.assign(positions.size(), EpdResult{});
+   atomic<size_t> next(0);
+   vector<thread> threads;
+   for (int i = 0; i < numThreads; i++)
+      threads.emplace_back([&]()
+      {
+         Board board(nullptr, true /*noreset*/);
+         Search search;
+         for (size_t p = next++; p < positions.size(); p = next++)
+            results[p] = check(board, search, positions[p]);
+      });
+   for (thread & t : threads)
+      t.join();
+   seconds = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+}
+
+/***************************************************
+ * EPD SUITE : NAME
+ * The position's id, or where it is in the file
+ ***************************************************/
+string EpdSuite::name(const EpdPosition & position) const
+{
+   return position.id.empty() ? "line " + to_string(position.lineNumber) : position.id;
+}
+
+/***************************************************
+ * EPD SUITE : DISPLAY
+ * One line per position, in the order of the file
+ ***************************************************/
+void EpdSuite::display(ostream & out)
+{
+   static const char * STATUS[] = { "pass", "FAIL", "skip" };
+   uint64_t nodes = 0;
+   for (size_t p = 0; p < results.size(); p++)
+   {
+      const EpdResult & result = results[p];
+      nodes += result.nodes;
+      out << left << setw(16) << name(positions[p])
+          << STATUS[result.status]
+          << "\tnodes " << result.nodes
+          << "\ttime " << result.seconds << "s";
+      if (!result.failure.empty())
+         out << "\t" << result.failure;
+      out << "\n";
+   }
+   out << "positions " << results.size()
+       << "\tnodes " << nodes
+       << "\ttime " << seconds << "s"
+       << "\tnps " << (seconds > 0.0 ? (uint64_t)(nodes / seconds) : 0)
+       << endl;
+}
+
+/***************************************************
+ * EPD SUITE : REPORT
+ * Each position checked is a test named after it, and
+ * a failure is reported at its line of the file
+ ***************************************************/
+void EpdSuite::report()
+{
+   for (size_t p = 0; p < results.size(); p++)
+      if (results[p].status != EpdResult::SKIP)
+         assertUnitParameters(results[p].status == EpdResult::PASS,
+                              results[p].failure.c_str(),
+                              positions[p].lineNumber,
+                              name(positions[p]).c_str());
+   UnitTest::report("EPD");
+}
@@ -0,0 +1,112 @@
+/***********************************************************************
+ * Header File:
+ *    EPD
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    Read a suite of positions in EPD (a FEN without the clocks, then
+ *    operations such as "bm Nf3;" or ";D5 4865609") and check every
+ *    one of them, spread across a pool of threads. The results are
+ *    summarized the same way the unit tests are.
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "search.h"
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Board;
+
+/***************************************************
+ * EPD POSITION
+ * One line of a suite: where to start and what to expect
+ ***************************************************/
+struct EpdPosition
+{
+   static const int MAX_DEPTH = 7;    // the deepest "Dn" operation read
+
+   std::string fen;                    // placement, side, castling, en passant
+   std::string id;                     // the "id" operation, if there is one
+   std::vector<std::string> bestMoves; // "bm": the moves to find, in SAN
+   std::vector<std::string> avoidMoves;// "am": the moves not to play, in SAN
+   uint64_t perft[MAX_DEPTH + 1];      // perft[d] is the "Dd" count, 0 if none
+   int lineNumber;                     // where in the file it came from
+};
+
+/***************************************************
+ * PARSE EPD
+ * Split one line into its FEN and operations. Returns
+ * false for a blank line or a comment starting with #
+ ***************************************************/
+bool parseEpd(std::string_view line, EpdPosition & position);
+
+/***************************************************
+ * PARSE SAN
+ * The legal move that standard algebraic notation such
+ * as "Nbd7", "exd6", "e8=Q+" or "O-O" names, or a null
+ * move if it names none or more than one
+ ***************************************************/
+PackedMove parseSan(const Board & board, std::string_view san);
+
+/***************************************************
+ * EPD RESULT
+ * How one position went
+ ***************************************************/
+struct EpdResult
+{
+   enum Status { PASS, FAIL, SKIP };
+
+   Status      status   = SKIP;
+   uint64_t    nodes    = 0;       // every node counted or searched
+   double      seconds  = 0.0;     // how long the position took
+   std::string failure;            // what was wrong, for a FAIL or a SKIP
+   PackedMove  bestMove;           // what the search chose, if it searched
+};
+
+/***************************************************
+ * EPD SUITE
+ * Every position of one or more EPD files, checked
+ * across a pool of threads. Each thread takes the next
+ * unclaimed position, so one slow position does not
+ * hold up the others
+ ***************************************************/
+class EpdSuite : public UnitTest
+{
+public:
+   EpdSuite() : maxDepth(EpdPosition::MAX_DEPTH), searchLimits(5 /*depth*/), seconds(0.0) { }
+
+   // add the positions from a file. Returns how many were read
+   int read(std::istream & in);
+   void add(const EpdPosition & position) { positions.push_back(position); }
+
+   // skip any "Dn" count deeper than this
+   void setMaxDepth(int depth) { maxDepth = depth; }
+
+   // how long to search a position with a "bm" or "am"
+   void setSearchLimits(const SearchLimits & limits) { searchLimits = limits; }
+
+   // check every position on numThreads threads, 0 for one per core
+   void run(int numThreads);
+
+   // one line per position, then the summary in the unit test style
+   void display(std::ostream & out);
+   void report();
+
+   const std::vector<EpdPosition> & getPositions() const { return positions; }
+   const std::vector<EpdResult>   & getResults()   const { return results;   }
+
+private:
+   EpdResult check(Board & board, Search & search, const EpdPosition & position) const;
+   std::string name(const EpdPosition & position) const;
+
+   std::vector<EpdPosition> positions;
+   std::vector<EpdResult>   results;    // results[i] is for positions[i]
+   int maxDepth;
+   SearchLimits searchLimits;
+   double seconds;                      // how long the last run() took
+};
@@ -0,0 +1,356 @@
+/***********************************************************************
+ * Source File:
+ *    MAGIC
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    The magic numbers, the search that found them, and the filling of
+ *    the rook and bishop attack tables. Searching takes tens of
+ *    milliseconds, so the program starts from the numbers written out
+ *    below and only fills the tables (about a millisecond). The search
+ *    is seeded: printMagics() finds these same numbers again.
+ *    Also here: asking the processor whether PEXT is worth using.
+ ************************************************************************/
+
+#include "magic.h"
+#include "attacks.h"    // for the ray walks the tables are checked against
+#include <chrono>       // for timing the startup
+#include <iomanip>      // for printing the numbers in hex
+#include <ostream>
+#include <cstring>      // for MEMCMP of the processor's vendor
+#if defined(_MSC_VER)
+#include <intrin.h>     // for __CPUIDEX
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>      // for __CPUID_COUNT
+#endif
+
+Magic ROOK_MAGICS[64];
+Magic BISHOP_MAGICS[64];
+SliderBackend SLIDER_BACKEND = SLIDER_MAGIC;
+
+namespace
+{
+   // every rook square together needs 102,400 entries, every bishop 5,248
+   Bitboard rookTable[0x19000];
+   Bitboard bishopTable[0x1480];
+
+   long long initMicroseconds = 0;
+
+   // one seed per rank, so the search is the same every run
+   const uint64_t SEEDS[8] = { 728, 10316, 55013, 32803, 12281, 15100, 16645, 255 };
+
+   // found by findMagic() from SEEDS; see printMagics()
+   const Bitboard ROOK_NUMBERS[64] =
+   {
+      0x0a80004000801220ULL, 0x8040004010002008ULL, 0x2080200010008008ULL, 0x1100100008210004ULL,
+      0xc200209084020008ULL, 0x2100010004000208ULL, 0x0400081000822421ULL, 0x0200010422048844ULL,
+      0x0800800080400024ULL, 0x0001402000401000ULL, 0x3000801000802001ULL, 0x4400800800100083ULL,
+      0x0904802402480080ULL, 0x4040800400020080ULL, 0x0018808042000100ULL, 0x4040800080004100ULL,
+      0x0040048001458024ULL, 0x00a0004000205000ULL, 0x3100808010002000ULL, 0x4825010010000820ULL,
+      0x5004808008000401ULL, 0x2024818004000a00ULL, 0x0005808002000100ULL, 0x2100060004806104ULL,
+      0x0080400880008421ULL, 0x4062220600410280ULL, 0x010a004a00108022ULL, 0x0000100080080080ULL,
+      0x0021000500080010ULL, 0x0044000202001008ULL, 0x0000100400080102ULL, 0xc020128200040545ULL,
+      0x0080002000400040ULL, 0x0000804000802004ULL, 0x0000120022004080ULL, 0x010a386103001001ULL,
+      0x9010080080800400ULL, 0x8440020080800400ULL, 0x0004228824001001ULL, 0x000000490a000084ULL,
+      0x0080002000504000ULL, 0x200020005000c000ULL, 0x0012088020420010ULL, 0x0010010080080800ULL,
+      0x0085001008010004ULL, 0x0002000204008080ULL, 0x0040413002040008ULL, 0x0000304081020004ULL,
+      0x0080204000800080ULL, 0x3008804000290100ULL, 0x1010100080200080ULL, 0x2008100208028080ULL,
+      0x5000850800910100ULL, 0x8402019004680200ULL, 0x0120911028020400ULL, 0x0000008044010200ULL,
+      0x0020850200244012ULL, 0x0020850200244012ULL, 0x0000102001040841ULL, 0x140900040a100021ULL,
+      0x000200282410a102ULL, 0x000200282410a102ULL, 0x000200282410a102ULL, 0x4048240043802106ULL
+   };
+   const Bitboard BISHOP_NUMBERS[64] =
+   {
+      0x40106000a1160020ULL, 0x0020010250810120ULL, 0x2010010220280081ULL, 0x002806004050c040ULL,
+      0x0002021018000000ULL, 0x2001112010000400ULL, 0x0881010120218080ULL, 0x1030820110010500ULL,
+      0x0000120222042400ULL, 0x2000020404040044ULL, 0x8000480094208000ULL, 0x0003422a02000001ULL,
+      0x000a220210100040ULL, 0x8004820202226000ULL, 0x0018234854100800ULL, 0x0100004042101040ULL,
+      0x0004001004082820ULL, 0x0010000810010048ULL, 0x1014004208081300ULL, 0x2080818802044202ULL,
+      0x0040880c00a00100ULL, 0x0080400200522010ULL, 0x0001000188180b04ULL, 0x0080249202020204ULL,
+      0x1004400004100410ULL, 0x00013100a0022206ULL, 0x2148500001040080ULL, 0x4241080011004300ULL,
+      0x4020848004002000ULL, 0x10101380d1004100ULL, 0x0008004422020284ULL, 0x01010a1041008080ULL,
+      0x0808080400082121ULL, 0x0808080400082121ULL, 0x0091128200100c00ULL, 0x0202200802010104ULL,
+      0x8c0a020200440085ULL, 0x01a0008080b10040ULL, 0x0889520080122800ULL, 0x100902022202010aULL,
+      0x04081a0816002000ULL, 0x0000681208005000ULL, 0x8170840041008802ULL, 0x0a00004200810805ULL,
+      0x0830404408210100ULL, 0x2602208106006102ULL, 0x1048300680802628ULL, 0x2602208106006102ULL,
+      0x0602010120110040ULL, 0x0941010801043000ULL, 0x000040440a210428ULL, 0x0008240020880021ULL,
+      0x0400002012048200ULL, 0x00ac102001210220ULL, 0x0220021002009900ULL, 0x84440c080a013080ULL,
+      0x0001008044200440ULL, 0x0004c04410841000ULL, 0x2000500104011130ULL, 0x1a0c010011c20229ULL,
+      0x0044800112202200ULL, 0x0434804908100424ULL, 0x0300404822c08200ULL, 0x48081010008a2a80ULL
+   };
+
+   /***************************************************
+    * RANDOM
+    * xorshift64*: quick, and good enough to pick candidates
+    ***************************************************/
+   uint64_t randomNumber(uint64_t & seed)
+   {
+      seed ^= seed >> 12;
+      seed ^= seed << 25;
+      seed ^= seed >> 27;
+      return seed * 2685821657736338717ULL;
+   }
+
+   // good magic numbers have few bits set
+   uint64_t sparseRandom(uint64_t & seed)
+   {
+      return randomNumber(seed) & randomNumber(seed) & randomNumber(seed);
+   }
+
+   /***************************************************
+    * SLIDER ATTACKS BY RAY
+    * The slow walk the tables are built from
+    ***************************************************/
+   Bitboard sliderAttacksByRay(int location, Bitboard occupied, bool isRook)
+   {
+      Bitboard attacks = EMPTY_BB;
+      for (int direction = 0; direction < 8; direction++)
+      {
+         bool isStraight = (direction % 4 < 2);
+         if (isStraight == isRook)
+            attacks |= rayAttacks(location, occupied, direction);
+      }
+      return attacks;
+   }
+
+   /***************************************************
+    * SLIDER MASK
+    * The squares a slider passes over on an empty board,
+    * less the last square of each ray: a piece there can
+    * not hide anything behind it
+    ***************************************************/
+   Bitboard sliderMask(int location, bool isRook)
+   {
+      Bitboard edges = ((RANK_1 | RANK_8) & ~(RANK_1 << (8 * rowOf(location)))) |
+                       ((FILE_A | FILE_H) & ~(FILE_A << colOf(location)));
+      return (isRook ? ATTACKS.rookRays[location] : ATTACKS.bishopRays[location]) & ~edges;
+   }
+
+   /***************************************************
+    * PREPARE MAGIC
+    * Everything about a square but its magic number
+    ***************************************************/
+   void prepareMagic(Magic & m, int location, bool isRook, Bitboard * table)
+   {
+      m.mask    = sliderMask(location, isRook);
+      m.shift   = 64 - popCount(m.mask);
+      m.attacks = table;
+   }
+
+   /***************************************************
+    * INIT MAGICS
+    * Fill every square's slice of the table from a known
+    * magic number. Each slice follows the one before it
+    ***************************************************/
+   void initMagics(Magic magics[64], Bitboard * table, bool isRook, const Bitboard numbers[64])
+   {
+      for (int location = 0; location < 64; location++)
+      {
+         Magic & m = magics[location];
+         prepareMagic(m, location, isRook, table);
+         m.magic = numbers[location];
+
+         // walk every subset of the mask (the "carry-rippler")
+         Bitboard blockers = EMPTY_BB;
+         do
+         {
+            m.attacks[m.index(blockers)] = sliderAttacksByRay(location, blockers, isRook);
+            blockers = (blockers - m.mask) & m.mask;
+         }
+         while (blockers);
+
+         table += (size_t)1 << (64 - m.shift);
+      }
+   }
+
+   void fillTables()
+   {
+      initMagics(ROOK_MAGICS,   rookTable,   true,  ROOK_NUMBERS);
+      initMagics(BISHOP_MAGICS, bishopTable, false, BISHOP_NUMBERS);
+   }
+
+   /***************************************************
+    * CPUID
+    * Ask the processor one question: EAX, EBX, ECX, EDX.
+    * Anything not x86 answers with zeros
+    ***************************************************/
+   void cpuid(unsigned leaf, unsigned regs[4])
+   {
+      regs[0] = regs[1] = regs[2] = regs[3] = 0;
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+      int r[4];
+      __cpuidex(r, (int)leaf, 0);
+      for (int i = 0; i < 4; i++)
+         regs[i] = (unsigned)r[i];
+#elif defined(__x86_64__) || defined(__i386__)
+      __cpuid_count(leaf, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+   }
+
+   /***************************************************
+    * MAGIC STARTUP
+    * Pick the backend and fill the tables before main() so a
+    * lookup never has to check whether they are ready. The ray
+    * tables are built by the compiler, so they are already
+    * there to fill from
+    ***************************************************/
+   struct MagicStartup
+   {
+      MagicStartup()
+      {
+         auto begin = std::chrono::steady_clock::now();
+         SLIDER_BACKEND = hasFastPext() ? SLIDER_PEXT : SLIDER_MAGIC;
+         fillTables();
+         auto end = std::chrono::steady_clock::now();
+         initMicroseconds = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+      }
+   } magicStartup;
+}
+
+/***************************************************
+ * FIND MAGIC
+ * List every set of blockers the mask allows and the attacks
+ * each gives. Then try sparse random numbers until one sends
+ * every set to an entry that is either unused or already holds
+ * the same attacks. An entry is unused when it was last written
+ * by an earlier candidate, so the table is never cleared
+ ***************************************************/
+int findMagic(Magic & m, int location, bool isRook, Bitboard * table, uint64_t & seed)
+{
+   Bitboard occupancy[4096];
+   Bitboard reference[4096];
+   int      epoch[4096] = {};
+
+   prepareMagic(m, location, isRook, table);
+
+   int size = 0;
+   Bitboard blockers = EMPTY_BB;
+   do
+   {
+      occupancy[size] = blockers;
+      reference[size] = sliderAttacksByRay(location, blockers, isRook);
+      size++;
+      blockers = (blockers - m.mask) & m.mask;
+   }
+   while (blockers);
+
+   for (int tries = 1; ; tries++)
+   {
+      // the top byte of the product must be well filled to spread the index
+      do
+         m.magic = sparseRandom(seed);
+      while (popCount((m.mask * m.magic) >> 56) < 6);
+
+      int i = 0;
+      for (; i < size; i++)
+      {
+         unsigned index = m.magicIndex(occupancy[i]);
+         if (epoch[index] < tries)
+         {
+            epoch[index] = tries;
+            table[index] = reference[i];
+         }
+         else if (table[index] != reference[i])
+            break;
+      }
+      if (i == size)
+         return tries;
+   }
+}
+
+/***************************************************
+ * PRINT MAGICS
+ * Search for every square's magic again, from the same
+ * seeds, and write the numbers out as they appear above.
+ * The search uses a scratch table so the live one is untouched
+ ***************************************************/
+void printMagics(std::ostream & out)
+{
+   static Bitboard scratch[4096];
+   for (int isRook = 1; isRook >= 0; isRook--)
+   {
+      out << (isRook ? "ROOK_NUMBERS" : "BISHOP_NUMBERS") << "\n";
+      int tries = 0;
+      for (int location = 0; location < 64; location++)
+      {
+         Magic m;
+         uint64_t seed = SEEDS[rowOf(location)];
+         tries += findMagic(m, location, isRook == 1, scratch, seed);
+         out << "0x" << std::hex << std::setw(16) << std::setfill('0') << m.magic
+             << std::dec << "ULL," << (location % 4 == 3 ? "\n" : " ");
+      }
+      out << tries << " candidates tried\n";
+   }
+}
+
+/***************************************************
+ * HAS PEXT
+ * CPUID leaf 7, EBX bit 8 is BMI2
+ ***************************************************/
+bool hasPext()
+{
+#ifdef BITBOARD_HAS_PEXT
+   unsigned regs[4];
+   cpuid(0, regs);
+   if (regs[0] < 7)
+      return false;
+   cpuid(7, regs);
+   return (regs[1] & (1u << 8)) != 0;
+#else
+   return false;
+#endif
+}
+
+/***************************************************
+ * HAS FAST PEXT
+ * Every Intel processor with BMI2 runs PEXT in hardware.
+ * AMD only does from family 19h (Zen 3); anyone else we
+ * do not know, so we stay with the multiply
+ ***************************************************/
+bool hasFastPext()
+{
+   if (!hasPext())
+      return false;
+
+   unsigned regs[4];
+   cpuid(0, regs);
+   char vendor[12];
+   memcpy(vendor + 0, &regs[1], 4);   // EBX, EDX, ECX spell the vendor
+   memcpy(vendor + 4, &regs[3], 4);
+   memcpy(vendor + 8, &regs[2], 4);
+   if (memcmp(vendor, "GenuineIntel", 12) == 0)
+      return true;
+   if (memcmp(vendor, "AuthenticAMD", 12) != 0)
+      return false;
+
+   cpuid(1, regs);
+   unsigned family = (regs[0] >> 8) & 0xf;
+   if (family == 0xf)
+      family += (regs[0] >> 20) & 0xff;
+   return family >= 0x19;
+}
+
+/***************************************************
+ * SET SLIDER BACKEND
+ ***************************************************/
+bool setSliderBackend(SliderBackend backend)
+{
+   if (backend == SLIDER_PEXT && !hasPext())
+      return false;
+   SLIDER_BACKEND = backend;
+   fillTables();
+   return true;
+}
+
+const char * sliderBackendName(SliderBackend backend)
+{
+   return backend == SLIDER_PEXT ? "pext" : "magic";
+}
+
+/***************************************************
+ * MAGIC INIT MICROSECONDS
+ ***************************************************/
+long long magicInitMicroseconds()
+{
+   return initMicroseconds;
+}
@@ -0,0 +1,103 @@
+/***********************************************************************
+ * Header File:
+ *    MAGIC
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    Magic bitboards: the squares a rook or bishop attacks, found with
+ *    one multiply, one shift and one table read. For each square, the
+ *    pieces that could block it (the mask) are multiplied by a magic
+ *    number chosen so that every different set of blockers that gives
+ *    different attacks lands on a different entry of the table.
+ *    The tables are filled once, before main() runs, from magic
+ *    numbers found ahead of time by findMagic().
+ *    Where the processor has a fast PEXT instruction (BMI2), the
+ *    mask gathers the blockers into the index directly and the
+ *    multiply is skipped. Which of the two is used is settled at
+ *    startup and can be forced with setSliderBackend().
+ ************************************************************************/
+
+#pragma once
+
+#include "bitboard.h"
+#include <cstdint>
+#include <iosfwd>
+
+/***************************************************
+ * SLIDER BACKEND
+ * How a set of blockers becomes a table index
+ ***************************************************/
+enum SliderBackend
+{
+   SLIDER_MAGIC,   // multiply and shift: runs anywhere
+   SLIDER_PEXT     // gather with PEXT: BMI2 processors only
+};
+
+extern SliderBackend SLIDER_BACKEND;
+
+/***************************************************
+ * MAGIC
+ * Everything needed to look up one square's attacks
+ ***************************************************/
+struct Magic
+{
+   Bitboard   mask;       // the squares whose pieces could block, edges excluded
+   Bitboard   magic;      // the multiplier
+   Bitboard * attacks;    // this square's slice of the attack table
+   int        shift;      // 64 less the number of squares in the mask
+
+   unsigned magicIndex(Bitboard occupied) const
+   {
+      return (unsigned)(((occupied & mask) * magic) >> shift);
+   }
+
+   unsigned index(Bitboard occupied) const
+   {
+#ifdef BITBOARD_HAS_PEXT
+      if (SLIDER_BACKEND == SLIDER_PEXT)
+         return (unsigned)pext(occupied, mask);
+#endif
+      return magicIndex(occupied);
+   }
+};
+
+extern Magic ROOK_MAGICS[64];
+extern Magic BISHOP_MAGICS[64];
+
+/***************************************************
+ * FIND MAGIC
+ * Search for a magic number for one square and fill its
+ * slice of the table. Returns the number of candidates tried
+ ***************************************************/
+int findMagic(Magic & m, int location, bool isRook, Bitboard * table, uint64_t & seed);
+
+/***************************************************
+ * PRINT MAGICS
+ * Search for every magic again and print the numbers
+ ***************************************************/
+void printMagics(std::ostream & out);
+
+/***************************************************
+ * HAS PEXT / HAS FAST PEXT
+ * Ask the processor whether it has PEXT at all, and whether
+ * it runs in a cycle or two. AMD processors before Zen 3
+ * have it, but in microcode that is slower than a multiply
+ ***************************************************/
+bool hasPext();
+bool hasFastPext();
+
+/***************************************************
+ * SET SLIDER BACKEND
+ * Switch how the tables are indexed and fill them again.
+ * Returns false, changing nothing, if PEXT is asked for on
+ * a processor without it. Not safe while anything else is
+ * generating moves
+ ***************************************************/
+bool setSliderBackend(SliderBackend backend);
+const char * sliderBackendName(SliderBackend backend);
+
+/***************************************************
+ * MAGIC INIT MICROSECONDS
+ * How long filling the tables took when the program started
+ ***************************************************/
+long long magicInitMicroseconds();
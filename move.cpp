@@ -27,12 +27,14 @@ Move::Move()
    moveType = MOVE_ERROR;
    isWhite = true;
    promote = PieceType::INVALID;
+   castleKing = castleQueen = enPassant = false;
 }
 
 /***************************************************
  * MOVE : CONSTRUCTOR
  ***************************************************/
-Move::Move(const string move)
+Move::Move(const string move) : promote(PieceType::INVALID), capture(SPACE),
+   moveType(MOVE), isWhite(true), castleKing(false), castleQueen(false), enPassant(false)
 {
    text = move;
    source.setFromText(move.substr(0, 2));
@@ -143,6 +145,19 @@ void Move::setMoveType(string move)
       moveType = MOVE;
 }
 
+/***************************************************
+ * SET MOVE TYPE: Set the move type directly
+ * Input: mt: MoveType
+ * Output: void
+ ***************************************************/
+void Move::setMoveType(MoveType mt)
+{
+   moveType    = mt;
+   enPassant   = (mt == ENPASSANT);
+   castleKing  = (mt == CASTLE_KING);
+   castleQueen = (mt == CASTLE_QUEEN);
+}
+
 /***************************************************
  * GET CAPTURED PIECE: Determine the piece type
  * Input: move: string
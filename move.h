@@ -32,15 +32,17 @@ public:
 
    // constructor
    Move();
-   Move(const Position &from, const Position &to): source(from), dest(to) {}
+   Move(const Position &from, const Position &to): source(from), dest(to),
+      promote(PieceType::INVALID), capture(SPACE), moveType(MOVE), isWhite(true),
+      castleKing(false), castleQueen(false), enPassant(false) {}
    Move(const string move);
    
    // getters
    const Position & getFrom() const                  { return source;   }
    const Position & getTo() const                    { return dest;     }
-   const PieceType getCapturedPieceType()            { return capture;  }
-   const PieceType & getPromotionPieceType()         { return promote;  }
-   const MoveType getMoveType()                      { return moveType; }
+   const PieceType getCapturedPieceType()      const { return capture;  }
+   const PieceType & getPromotionPieceType()   const { return promote;  }
+   const MoveType getMoveType()                const { return moveType; }
    const bool getCapturedPieceColor();
    const PieceType & getPrevPiece();
    const bool getPrevPieceColor();
@@ -48,6 +50,7 @@ public:
    
    // setters
    void setMoveType(string move);
+   void setMoveType(MoveType mt);
    void setCapturedPieceType(string move);
    void setPromotionPiece(PieceType pt) { promote = pt; } //Added for promotion 10/16/2024
    void setCapture(PieceType capturedPiece) { capture = capturedPiece; }
@@ -151,6 +154,7 @@ public:
    const string getText();
    int readAndAssign(string move);
    void setMoveType(string move);
+   void setMoveType(MoveType mt);
 };
 
 /***************************************************
@@ -180,6 +184,7 @@ public:
    const string getText();
    int readAndAssign(string move);
    void setMoveType(string move);
+   void setMoveType(MoveType mt);
    void setCapturedPieceType(string move);
    bool isEnPassant(string move);
    bool isCastleKing(string move);
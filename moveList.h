@@ -0,0 +1,83 @@
+/***********************************************************************
+ * Header File:
+ *    MOVE LIST
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    A fixed-capacity list of moves that lives on the stack. Move
+ *    generation fills one of these instead of a std::set so that no
+ *    move costs a heap allocation. Moves are kept in their packed form.
+ ************************************************************************/
+
+#pragma once
+
+#include <algorithm>   // for std::sort
+#include <cassert>
+#include "movePacked.h"
+
+class TestMoveList;
+
+/***************************************************
+ * MOVE LIST
+ * Up to CAPACITY moves in the order they were generated
+ ***************************************************/
+class MoveList
+{
+   friend TestMoveList;
+public:
+   // no legal chess position has more than 218 moves
+   static const int CAPACITY = 256;
+
+   MoveList() : num(0) {}
+
+   // getters
+   int  size()  const                             { return num;             }
+   bool empty() const                             { return num == 0;        }
+   bool full()  const                             { return num == CAPACITY; }
+   const PackedMove & operator [] (int i) const   { assert(0 <= i && i < num); return moves[i]; }
+   PackedMove & operator [] (int i)               { assert(0 <= i && i < num); return moves[i]; }
+
+   // iteration
+   PackedMove * begin()                           { return moves;           }
+   PackedMove * end()                             { return moves + num;     }
+   const PackedMove * begin() const               { return moves;           }
+   const PackedMove * end()   const               { return moves + num;     }
+
+   // setters
+   void clear()                                   { num = 0;                }
+   void add(const PackedMove & move)
+   {
+      assert(num < CAPACITY);
+      moves[num++] = move;
+   }
+
+   /***************************************************
+    * CONTAINS
+    * Is there a move with the same source and destination?
+    * This matches what std::set<Move>::find() would report.
+    ***************************************************/
+   bool contains(const PackedMove & move) const
+   {
+      return find(move) != end();
+   }
+   const PackedMove * find(const PackedMove & move) const
+   {
+      for (const PackedMove * p = begin(); p != end(); ++p)
+         if (p->sameSquares(move))
+            return p;
+      return end();
+   }
+
+   /***************************************************
+    * SORT
+    * Order the moves the same way std::set<Move> would
+    ***************************************************/
+   void sort()
+   {
+      std::sort(begin(), end());
+   }
+
+private:
+   PackedMove moves[CAPACITY];
+   int        num;
+};
@@ -0,0 +1,265 @@
+/***********************************************************************
+ * Source File:
+ *    PACKED MOVE
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    Conversions between the 16-bit move and Smith notation
+ ************************************************************************/
+
+#include "movePacked.h"
+#include <cassert>
+using namespace std;
+
+/***************************************************
+ * PACKED MOVE : CONSTRUCT FROM MOVE
+ * Keep the squares, the move type and the promotion
+ ***************************************************/
+PackedMove::PackedMove(const Move & move) : bits(0)
+{
+   int flag = QUIET;
+   PieceType capture = move.getCapturedPieceType();
+   bool isCapture = (capture != SPACE && capture != INVALID);
+   PieceType promote = move.getPromotionPieceType();
+
+   if (move.getMoveType() == Move::ENPASSANT)
+      flag = ENPASSANT;
+   else if (move.getMoveType() == Move::CASTLE_KING)
+      flag = CASTLE_KING;
+   else if (move.getMoveType() == Move::CASTLE_QUEEN)
+      flag = CASTLE_QUEEN;
+   else if (promote == QUEEN || promote == ROOK || promote == BISHOP || promote == KNIGHT)
+      flag = promoteFlag(promote, isCapture);
+   else if (isCapture)
+      flag = CAPTURE;
+
+   *this = PackedMove(move.getFrom(), move.getTo(), flag);
+}
+
+/***************************************************
+ * PACKED MOVE : CONSTRUCT FROM TEXT
+ * Smith notation: source, destination, then an optional
+ * captured piece (lowercase), E for en-passant, c or C
+ * for castling, and an optional promotion (uppercase)
+ *    e5c6r   b7b8Q   a7b8nQ   a5b6E   e1g1c   e1c1C
+ ***************************************************/
+PackedMove::PackedMove(const string & text) : bits(0)
+{
+   if (text.length() < 4)
+      return;
+   Position from(text.substr(0, 2));
+   Position to(text.substr(2, 2));
+   if (from.isInvalid() || to.isInvalid())
+      return;
+
+   int flag = QUIET;
+   bool isCapture = captureFromText(text) != SPACE;
+   if (isCapture)
+      flag = CAPTURE;
+   for (size_t i = 4; i < text.length(); i++)
+   {
+      switch (text[i])
+      {
+         case 'E':
+            flag = ENPASSANT;
+            break;
+         case 'c':
+            flag = CASTLE_KING;
+            break;
+         case 'C':
+            flag = CASTLE_QUEEN;
+            break;
+         case 'N':
+            flag = promoteFlag(KNIGHT, isCapture);
+            break;
+         case 'B':
+            flag = promoteFlag(BISHOP, isCapture);
+            break;
+         case 'R':
+            flag = promoteFlag(ROOK, isCapture);
+            break;
+         case 'Q':
+            flag = promoteFlag(QUEEN, isCapture);
+            break;
+         default:
+            break;
+      }
+   }
+
+   *this = PackedMove(from, to, flag);
+}
+
+/***************************************************
+ * PACKED MOVE : PROMOTE FLAG
+ * The flag for promoting to a given piece
+ ***************************************************/
+int PackedMove::promoteFlag(PieceType pt, bool isCapture)
+{
+   int base = isCapture ? PROMOTE_CAPTURE : PROMOTE;
+   switch (pt)
+   {
+      case KNIGHT:
+         return base + 0;
+      case BISHOP:
+         return base + 1;
+      case ROOK:
+         return base + 2;
+      default:
+         return base + 3;
+   }
+}
+
+/***************************************************
+ * PACKED MOVE : GET PROMOTION
+ * The piece a pawn becomes, or SPACE if this is no promotion
+ ***************************************************/
+PieceType PackedMove::getPromotion() const
+{
+   if (!isPromotion())
+      return SPACE;
+   const PieceType promotions[4] = { KNIGHT, BISHOP, ROOK, QUEEN };
+   return promotions[getFlag() & 3];
+}
+
+/***************************************************
+ * PACKED MOVE : CAPTURE FROM TEXT
+ * The captured piece named in Smith notation, if any
+ ***************************************************/
+PieceType PackedMove::captureFromText(const string & text)
+{
+   for (size_t i = 4; i < text.length(); i++)
+   {
+      switch (text[i])
+      {
+         case 'p':
+         case 'E':
+            return PAWN;
+         case 'n':
+            return KNIGHT;
+         case 'b':
+            return BISHOP;
+         case 'r':
+            return ROOK;
+         case 'q':
+            return QUEEN;
+         case 'k':
+            return KING;
+         default:
+            break;
+      }
+   }
+   return SPACE;
+}
+
+/***************************************************
+ * PACKED MOVE : GET TEXT
+ * Smith notation for this move. Since the move does not
+ * know what it captured, the caller tells it
+ ***************************************************/
+string PackedMove::getText(PieceType capture) const
+{
+   if (isNull())
+      return "";
+
+   string text = Position(getFrom()).getText() + Position(getTo()).getText();
+   if (isEnPassant())
+      text += 'E';
+   else if (getFlag() == CASTLE_KING)
+      text += 'c';
+   else if (getFlag() == CASTLE_QUEEN)
+      text += 'C';
+   else if (isCapture())
+   {
+      switch (capture)
+      {
+         case PAWN:
+            text += 'p';
+            break;
+         case KNIGHT:
+            text += 'n';
+            break;
+         case BISHOP:
+            text += 'b';
+            break;
+         case ROOK:
+            text += 'r';
+            break;
+         case QUEEN:
+            text += 'q';
+            break;
+         case KING:
+            text += 'k';
+            break;
+         default:
+            break;
+      }
+   }
+
+   switch (getPromotion())
+   {
+      case KNIGHT:
+         text += 'N';
+         break;
+      case BISHOP:
+         text += 'B';
+         break;
+      case ROOK:
+         text += 'R';
+         break;
+      case QUEEN:
+         text += 'Q';
+         break;
+      default:
+         break;
+   }
+   return text;
+}
+
+/***************************************************
+ * PACKED MOVE : GET LONG ALGEBRAIC
+ * Source, destination and any promotion, "e7e8q", the
+ * way other engines print their moves
+ ***************************************************/
+string PackedMove::getLongAlgebraic() const
+{
+   if (isNull())
+      return "0000";
+
+   string text = Position(getFrom()).getText() + Position(getTo()).getText();
+   switch (getPromotion())
+   {
+      case QUEEN:  text += 'q'; break;
+      case ROOK:   text += 'r'; break;
+      case BISHOP: text += 'b'; break;
+      case KNIGHT: text += 'n'; break;
+      default:                  break;
+   }
+   return text;
+}
+
+/***************************************************
+ * PACKED MOVE : GET MOVE
+ * Expand into the full Move that Board::move() takes
+ ***************************************************/
+Move PackedMove::getMove(PieceType capture) const
+{
+   Position from(getFrom());
+   Position to(getTo());
+   Move move(from, to);
+
+   if (isEnPassant())
+   {
+      move.setMoveType(Move::ENPASSANT);
+      move.setCapture(PAWN);
+   }
+   else if (getFlag() == CASTLE_KING)
+      move.setMoveType(Move::CASTLE_KING);
+   else if (getFlag() == CASTLE_QUEEN)
+      move.setMoveType(Move::CASTLE_QUEEN);
+   else
+      move.setCapture(isCapture() ? capture : SPACE);
+
+   if (isPromotion())
+      move.setPromotionPiece(getPromotion());
+   return move;
+}
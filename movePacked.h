@@ -0,0 +1,91 @@
+/***********************************************************************
+ * Header File:
+ *    PACKED MOVE
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    A chess move squeezed into 16 bits so move lists and history
+ *    stacks stay small:
+ *       bits  0..5   source location      (0..63, a1 = 0)
+ *       bits  6..11  destination location (0..63)
+ *       bits 12..15  flag                 (see PackedMove::Flag)
+ *    Which piece was captured is not part of the move. The board knows
+ *    it (and the undo stack remembers it), so the text conversions take
+ *    the captured PieceType as separate metadata.
+ ************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include "pieceType.h"
+#include "position.h"
+#include "move.h"
+
+class TestPackedMove;
+
+/***************************************************
+ * PACKED MOVE
+ * One move across the board in two bytes
+ ***************************************************/
+class PackedMove
+{
+   friend TestPackedMove;
+public:
+   // bit 2 of the flag means "capture" and bit 3 means "promotion"
+   enum Flag
+   {
+      QUIET           = 0,
+      CASTLE_KING     = 2,
+      CASTLE_QUEEN    = 3,
+      CAPTURE         = 4,
+      ENPASSANT       = 5,
+      PROMOTE         = 8,   // + 0 knight, 1 bishop, 2 rook, 3 queen
+      PROMOTE_CAPTURE = 12   // + 0 knight, 1 bishop, 2 rook, 3 queen
+   };
+
+   // constructors
+   PackedMove() : bits(0) {}
+   PackedMove(int from, int to, int flag = QUIET)
+      : bits((uint16_t)(from | (to << 6) | (flag << 12))) {}
+   PackedMove(const Position & from, const Position & to, int flag = QUIET)
+      : PackedMove(from.getLocation(), to.getLocation(), flag) {}
+   explicit PackedMove(const Move & move);
+   explicit PackedMove(const std::string & text);
+
+   // getters
+   int  getFrom()          const { return bits & 0x3f;         }
+   int  getTo()            const { return (bits >> 6) & 0x3f;  }
+   int  getFlag()          const { return bits >> 12;          }
+   uint16_t getBits()      const { return bits;                }
+   bool isNull()           const { return bits == 0;           }
+   bool isCapture()        const { return (getFlag() & CAPTURE) != 0; }
+   bool isPromotion()      const { return (getFlag() & PROMOTE) != 0; }
+   bool isEnPassant()      const { return getFlag() == ENPASSANT;      }
+   bool isCastle()         const { return getFlag() == CASTLE_KING ||
+                                          getFlag() == CASTLE_QUEEN;   }
+   PieceType getPromotion() const;
+
+   // same source and destination, ignoring the flag
+   bool sameSquares(const PackedMove & rhs) const
+   {
+      return ((bits ^ rhs.bits) & 0x0fff) == 0;
+   }
+
+   // conversions back to the textual and the full Move
+   std::string getText(PieceType capture = SPACE) const;
+   std::string getLongAlgebraic() const;
+   Move        getMove(PieceType capture = SPACE) const;
+   static PieceType captureFromText(const std::string & text);
+   static int       promoteFlag(PieceType pt, bool isCapture);
+
+   bool operator == (const PackedMove & rhs) const { return bits == rhs.bits; }
+   bool operator != (const PackedMove & rhs) const { return bits != rhs.bits; }
+   bool operator <  (const PackedMove & rhs) const { return sortKey() < rhs.sortKey(); }
+
+private:
+   // order by source, then destination, the same as Move::operator<
+   int sortKey() const { return (getFrom() << 10) | (getTo() << 4) | getFlag(); }
+
+   uint16_t bits;
+};
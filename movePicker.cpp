@@ -0,0 +1,175 @@
+/***********************************************************************
+ * Source File:
+ *    MOVE PICKER
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    The staged move picker the search takes its moves from
+ ************************************************************************/
+
+#include "movePicker.h"
+#include "board.h"
+#include "pieceType.h"  // for PIECE_VALUES
+#include <utility>      // for swap()
+using namespace std;
+
+/***************************************************
+ * MVV LVA RANK
+ * How much each PieceType is worth, in the order a
+ * capture cares about: a pawn least, the king most
+ ***************************************************/
+static const int MVV_LVA_RANK[8] =
+{
+   0,    // INVALID
+   0,    // SPACE
+   6,    // KING
+   5,    // QUEEN
+   4,    // ROOK
+   3,    // BISHOP
+   2,    // KNIGHT
+   1     // PAWN
+};
+
+/***************************************************
+ * MVV LVA
+ * The victim counts eight times the attacker, so no
+ * choice of attacker makes up for a smaller victim
+ ***************************************************/
+int mvvLva(const Board & board, const PackedMove & move)
+{
+   PieceType victim = move.isEnPassant() ? PAWN :
+                      move.isCapture()   ? board.getPieceType(move.getTo()) : SPACE;
+   int score = 8 * MVV_LVA_RANK[victim] - MVV_LVA_RANK[board.getPieceType(move.getFrom())];
+   if (move.isPromotion())
+      score += 8 * MVV_LVA_RANK[move.getPromotion()];
+   return score;
+}
+
+/***************************************************
+ * MOVE PICKER : CONSTRUCTOR
+ * Nothing is generated until next() is called
+ ***************************************************/
+MovePicker::MovePicker(const Board & board, const PackedMove & tableMove,
+                       const PackedMove & killer1, const PackedMove & killer2,
+                       const ButterflyHistory * pHistory)
+   : board(board), stage(STAGE_TABLE), tableMove(tableMove), killerIndex(0),
+     pHistory(pHistory), captureIndex(0), badCaptureIndex(0), quietIndex(0)
+{
+   killers[0] = killer1;
+   killers[1] = killer2;
+}
+
+/***************************************************
+ * MOVE PICKER : PICK BEST
+ * Bring the highest scoring of the moves not yet
+ * given to the front and give it. A full sort would
+ * be wasted on a node that cuts off after a move or two
+ ***************************************************/
+PackedMove MovePicker::pickBest(MoveList & moves, int * scores, int & index)
+{
+   int best = index;
+   for (int i = index + 1; i < moves.size(); i++)
+      if (scores[i] > scores[best])
+         best = i;
+   swap(moves[index], moves[best]);
+   swap(scores[index], scores[best]);
+   return moves[index++];
+}
+
+/***************************************************
+ * MOVE PICKER : IS GOOD CAPTURE
+ * Does the exchange on the square lose no more than half
+ * a pawn? A bishop for a knight is an even trade
+ ***************************************************/
+bool MovePicker::isGoodCapture(const PackedMove & move) const
+{
+   return board.seeGE(move, -PIECE_VALUES[PAWN] / 2);
+}
+
+/***************************************************
+ * MOVE PICKER : IS PICKED
+ * Was this move given in an earlier stage?
+ ***************************************************/
+bool MovePicker::isPicked(const PackedMove & move) const
+{
+   return move == tableMove || move == killers[0] || move == killers[1];
+}
+
+/***************************************************
+ * MOVE PICKER : NEXT
+ * Each stage falls through to the next when it has
+ * nothing more to give
+ ***************************************************/
+PackedMove MovePicker::next()
+{
+   switch (stage)
+   {
+      case STAGE_TABLE:
+         stage = STAGE_GENERATE_CAPTURES;
+         if (board.isLegal(tableMove))
+            return tableMove;
+         tableMove = PackedMove();
+         [[fallthrough]];
+
+      case STAGE_GENERATE_CAPTURES:
+         board.generateLegalMoves(captures, GEN_CAPTURES);
+         for (int i = 0; i < captures.size(); i++)
+            captureScores[i] = mvvLva(board, captures[i]);
+         stage = STAGE_GOOD_CAPTURES;
+         [[fallthrough]];
+
+      case STAGE_GOOD_CAPTURES:
+         while (captureIndex < captures.size())
+         {
+            PackedMove move = pickBest(captures, captureScores, captureIndex);
+            if (move == tableMove)
+               continue;
+            if (!isGoodCapture(move))
+               badCaptures.add(move);
+            else
+               return move;
+         }
+         stage = STAGE_KILLERS;
+         [[fallthrough]];
+
+      case STAGE_KILLERS:
+         while (killerIndex < 2)
+         {
+            const PackedMove & killer = killers[killerIndex++];
+            if (!killer.isNull() && !(killer == tableMove) &&
+                !killer.isCapture() && !killer.isPromotion() &&
+                !(killerIndex == 2 && killer == killers[0]) &&
+                board.isLegal(killer))
+               return killer;
+         }
+         stage = STAGE_GENERATE_QUIETS;
+         [[fallthrough]];
+
+      case STAGE_GENERATE_QUIETS:
+         board.generateLegalMoves(quiets, GEN_QUIETS);
+         for (int i = 0; i < quiets.size(); i++)
+            quietScores[i] = pHistory ? (*pHistory)[quiets[i].getFrom()][quiets[i].getTo()] : 0;
+         stage = STAGE_QUIETS;
+         [[fallthrough]];
+
+      case STAGE_QUIETS:
+         while (quietIndex < quiets.size())
+         {
+            PackedMove move = pickBest(quiets, quietScores, quietIndex);
+            if (!isPicked(move))
+               return move;
+         }
+         stage = STAGE_BAD_CAPTURES;
+         [[fallthrough]];
+
+      case STAGE_BAD_CAPTURES:
+         if (badCaptureIndex < badCaptures.size())
+            return badCaptures[badCaptureIndex++];
+         stage = STAGE_DONE;
+         [[fallthrough]];
+
+      case STAGE_DONE:
+         break;
+   }
+   return PackedMove();
+}
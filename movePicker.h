@@ -0,0 +1,91 @@
+/***********************************************************************
+ * Header File:
+ *    MOVE PICKER
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    Hand the search its moves one at a time, most promising first,
+ *    generating each kind only when the ones before it are used up.
+ *    Most nodes that cut off do so on the table's move or a capture,
+ *    and never pay for the quiet moves at all.
+ ************************************************************************/
+
+#pragma once
+
+#include "movePacked.h"
+#include "moveList.h"
+
+class Board;
+class TestMovePicker;
+
+/***************************************************
+ * BUTTERFLY HISTORY
+ * For one side, how often each quiet move, by its source
+ * and destination squares, has cut off in the search
+ ***************************************************/
+typedef int ButterflyHistory[64][64];
+
+/***************************************************
+ * MVV LVA
+ * The order to try captures in: the most valuable victim
+ * first, and of the captures of the same victim, the one
+ * by the least valuable attacker. A promotion counts the
+ * piece the pawn becomes as part of the prize
+ ***************************************************/
+int mvvLva(const Board & board, const PackedMove & move);
+
+/***************************************************
+ * MOVE PICKER
+ * The stages, in order:
+ *    the move from the transposition table, if it is legal
+ *    the captures and promotions that do not lose material
+ *    the killers: quiet moves that cut off at this ply elsewhere
+ *    the rest of the quiet moves, by their history
+ *    the captures that lose material
+ * No move is given twice
+ ***************************************************/
+class MovePicker
+{
+   friend TestMovePicker;
+public:
+   MovePicker(const Board & board, const PackedMove & tableMove,
+              const PackedMove & killer1 = PackedMove(),
+              const PackedMove & killer2 = PackedMove(),
+              const ButterflyHistory * pHistory = nullptr);
+
+   // the next move to try, null when there are no more
+   PackedMove next();
+
+private:
+   enum Stage
+   {
+      STAGE_TABLE,
+      STAGE_GENERATE_CAPTURES,
+      STAGE_GOOD_CAPTURES,
+      STAGE_KILLERS,
+      STAGE_GENERATE_QUIETS,
+      STAGE_QUIETS,
+      STAGE_BAD_CAPTURES,
+      STAGE_DONE
+   };
+
+   bool isGoodCapture(const PackedMove & move) const;
+   bool isPicked(const PackedMove & move) const;
+   static PackedMove pickBest(MoveList & moves, int * scores, int & index);
+
+   const Board & board;
+   Stage      stage;
+   PackedMove tableMove;
+   PackedMove killers[2];
+   int        killerIndex;
+   const ButterflyHistory * pHistory;      // the side to move's, if any
+
+   MoveList captures;                      // best taken from the front
+   int      captureScores[MoveList::CAPACITY];
+   int      captureIndex;
+   MoveList badCaptures;                   // set aside for the end
+   int      badCaptureIndex;
+   MoveList quiets;
+   int      quietScores[MoveList::CAPACITY];
+   int      quietIndex;
+};
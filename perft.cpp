@@ -0,0 +1,281 @@
+/***********************************************************************
+ * Source File:
+ *    PERFT
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    Count the leaf nodes of the legal move tree to a fixed depth
+ ************************************************************************/
+
+#include "perft.h"
+#include "board.h"
+#include <atomic>
+#include <cassert>
+#include <thread>
+using namespace std;
+
+/***************************************************
+ * PERFT
+ * Every legal move, counted straight from the move list
+ * at the last ply rather than by making each one
+ ***************************************************/
+uint64_t perft(Board & board, int depth)
+{
+   assert(depth >= 0);
+   if (depth == 0)
+      return 1;
+
+   MoveList moves;
+   board.generateLegalMoves(moves);
+   if (depth == 1)
+      return moves.size();
+
+   uint64_t nodes = 0;
+   for (const PackedMove & move : moves)
+   {
+      board.makeMove(move);
+      nodes += perft(board, depth - 1);
+      board.unmakeMove();
+   }
+   return nodes;
+}
+
+/***************************************************
+ * PERFT HASH : CONSTRUCT
+ * The largest power of two buckets that fits
+ ***************************************************/
+PerftHash::PerftHash(size_t megabytes) : numProbes(0), numHits(0)
+{
+   size_t numBuckets = 1;
+   while (numBuckets * 2 * sizeof(Bucket) <= megabytes * 1024 * 1024)
+      numBuckets *= 2;
+   buckets.assign(numBuckets, Bucket{});
+   mask = numBuckets - 1;
+}
+
+/***************************************************
+ * PERFT HASH : CLEAR
+ ***************************************************/
+void PerftHash::clear()
+{
+   buckets.assign(buckets.size(), Bucket{});
+   numProbes = 0;
+   numHits   = 0;
+}
+
+/***************************************************
+ * PERFT HASH : PROBE
+ * The whole key must match, not only the bits that
+ * picked the bucket, and so must the depth
+ ***************************************************/
+bool PerftHash::probe(uint64_t key, int depth, uint64_t & nodes)
+{
+   numProbes++;
+   const Bucket & bucket = buckets[key & mask];
+   for (const Entry * p : { &bucket.deepest, &bucket.recent })
+      if (p->key == key && (int)(p->data & 0xff) == depth)
+      {
+         numHits++;
+         nodes = p->data >> 8;
+         return true;
+      }
+   return false;
+}
+
+/***************************************************
+ * PERFT HASH : STORE
+ * A count at least as deep as the one kept replaces
+ * it; anything shallower goes in the other entry
+ ***************************************************/
+void PerftHash::store(uint64_t key, int depth, uint64_t nodes)
+{
+   assert(depth > 0 && depth < 256);
+   Bucket & bucket = buckets[key & mask];
+   Entry & entry = (depth >= (int)(bucket.deepest.data & 0xff)) ? bucket.deepest : bucket.recent;
+   entry.key  = key;
+   entry.data = (nodes << 8) | (uint64_t)depth;
+}
+
+/***************************************************
+ * PERFT HASHED
+ ***************************************************/
+uint64_t perft(Board & board, int depth, PerftHash & hash)
+{
+   assert(depth >= 0);
+   if (depth == 0)
+      return 1;
+
+   uint64_t nodes = 0;
+   if (depth >= 2 && hash.probe(board.getKey(), depth, nodes))
+      return nodes;
+
+   MoveList moves;
+   board.generateLegalMoves(moves);
+   if (depth == 1)
+      return moves.size();
+
+   for (const PackedMove & move : moves)
+   {
+      board.makeMove(move);
+      nodes += perft(board, depth - 1, hash);
+      board.unmakeMove();
+   }
+   hash.store(board.getKey(), depth, nodes);
+   return nodes;
+}
+
+/***************************************************
+ * COPY MAKE
+ * perft() with a snapshot copied back in place of unmakeMove()
+ ***************************************************/
+static uint64_t copyMake(Board & board, int depth)
+{
+   if (depth == 0)
+      return 1;
+
+   MoveList moves;
+   board.generateLegalMoves(moves);
+   if (depth == 1)
+      return moves.size();
+
+   BoardSnapshot saved = board.getSnapshot();
+   uint64_t nodes = 0;
+   for (const PackedMove & move : moves)
+   {
+      board.makeMove(move);
+      nodes += copyMake(board, depth - 1);
+      board.setSnapshot(saved);
+   }
+   return nodes;
+}
+
+/***************************************************
+ * PERFT COPY MAKE
+ * Count on a board of our own, built from a snapshot,
+ * since setSnapshot() forgets the caller's undo stack
+ ***************************************************/
+uint64_t perftCopyMake(const Board & board, int depth)
+{
+   assert(depth >= 0);
+   Board copy(board.getSnapshot());
+   return copyMake(copy, depth);
+}
+
+/***************************************************
+ * DIVIDE
+ * The same count as perft(), reported per root move
+ ***************************************************/
+uint64_t divide(Board & board, int depth, ostream & out)
+{
+   assert(depth >= 1);
+   MoveList moves;
+   board.generateLegalMoves(moves);
+   moves.sort();
+
+   uint64_t total = 0;
+   for (const PackedMove & move : moves)
+   {
+      board.makeMove(move);
+      uint64_t nodes = perft(board, depth - 1);
+      out << move.getLongAlgebraic() << ": " << nodes << "\n";
+      total += nodes;
+      board.unmakeMove();
+   }
+   out << "Total: " << total << "\n";
+   return total;
+}
+
+/***************************************************
+ * PERFT WORK
+ * One subtree for a thread to count: the moves leading
+ * to it from the root, and how deep to go from there
+ ***************************************************/
+struct PerftWork
+{
+   PackedMove moves[2];
+   int numMoves;
+};
+
+/***************************************************
+ * COLLECT WORK
+ * Every legal move sequence splitPly plies long
+ ***************************************************/
+static void collectWork(Board & board, int splitPly, PerftWork & work,
+                        vector<PerftWork> & queue)
+{
+   if (work.numMoves == splitPly)
+   {
+      queue.push_back(work);
+      return;
+   }
+
+   MoveList moves;
+   board.generateLegalMoves(moves);
+   for (const PackedMove & move : moves)
+   {
+      board.makeMove(move);
+      work.moves[work.numMoves++] = move;
+      collectWork(board, splitPly, work, queue);
+      work.numMoves--;
+      board.unmakeMove();
+   }
+}
+
+/***************************************************
+ * PERFT PARALLEL
+ * The threads take the next unclaimed subtree until
+ * none are left, so a slow subtree does not hold up
+ * the others waiting on it
+ ***************************************************/
+uint64_t perftParallel(const Board & board, int depth, int numThreads,
+                       vector<uint64_t> * pNodesPerThread)
+{
+   assert(depth >= 0);
+   if (numThreads < 1)
+      numThreads = 1;
+
+   // too shallow to be worth splitting
+   Board root(board);
+   int splitPly = (depth >= 3) ? 2 : 1;
+   if (depth < 2 || numThreads == 1)
+   {
+      uint64_t nodes = perft(root, depth);
+      if (pNodesPerThread)
+         pNodesPerThread->assign(1, nodes);
+      return nodes;
+   }
+
+   vector<PerftWork> queue;
+   PerftWork work;
+   work.numMoves = 0;
+   collectWork(root, splitPly, work, queue);
+
+   atomic<size_t> next(0);
+   vector<uint64_t> nodesPerThread(numThreads, 0);
+   vector<thread> threads;
+   for (int i = 0; i < numThreads; i++)
+      threads.emplace_back([&, i]()
+      {
+         Board mine(root);
+         uint64_t nodes = 0;
+         for (size_t w = next++; w < queue.size(); w = next++)
+         {
+            for (int m = 0; m < queue[w].numMoves; m++)
+               mine.makeMove(queue[w].moves[m]);
+            nodes += perft(mine, depth - queue[w].numMoves);
+            for (int m = 0; m < queue[w].numMoves; m++)
+               mine.unmakeMove();
+         }
+         nodesPerThread[i] = nodes;
+      });
+
+   uint64_t total = 0;
+   for (int i = 0; i < numThreads; i++)
+   {
+      threads[i].join();
+      total += nodesPerThread[i];
+   }
+   if (pNodesPerThread)
+      *pNodesPerThread = nodesPerThread;
+   return total;
+}
@@ -0,0 +1,100 @@
+/***********************************************************************
+ * Header File:
+ *    PERFT
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    Count the leaf nodes of the legal move tree to a fixed depth.
+ *    The counts for well-known positions are published, so perft is
+ *    how we check the move generator before we trust any speedup.
+ ************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+class Board;
+
+/***************************************************
+ * PERFT
+ * The number of legal move sequences of exactly depth plies
+ * from the board's current position. The board is left as found.
+ ***************************************************/
+uint64_t perft(Board & board, int depth);
+
+/***************************************************
+ * PERFT HASH
+ * The counts of subtrees already walked, keyed by the
+ * Zobrist key and depth, so a position reached again by
+ * another move order is counted once. Each bucket holds two
+ * entries: one kept for the deepest count, one always replaced
+ ***************************************************/
+class PerftHash
+{
+public:
+   // a table of about megabytes MB, rounded down to a power of two
+   PerftHash(size_t megabytes);
+
+   // the count stored for this position and depth, if there is one
+   bool probe(uint64_t key, int depth, uint64_t & nodes);
+   void store(uint64_t key, int depth, uint64_t nodes);
+   void clear();
+
+   size_t   getNumEntries() const { return buckets.size() * 2; }
+   uint64_t getNumProbes()  const { return numProbes;           }
+   uint64_t getNumHits()    const { return numHits;             }
+   double   getHitRate()    const { return numProbes ? (double)numHits / numProbes : 0.0; }
+
+private:
+   struct Entry
+   {
+      uint64_t key;
+      uint64_t data;     // the count above 8 bits, the depth below
+   };
+   struct Bucket
+   {
+      Entry deepest;
+      Entry recent;
+   };
+
+   std::vector<Bucket> buckets;
+   size_t   mask;
+   uint64_t numProbes;
+   uint64_t numHits;
+};
+
+/***************************************************
+ * PERFT HASHED
+ * perft(), looking up every subtree of depth 2 or more
+ * in the hash before walking it
+ ***************************************************/
+uint64_t perft(Board & board, int depth, PerftHash & hash);
+
+/***************************************************
+ * PERFT COPY MAKE
+ * The same count as perft(), but each position is saved
+ * as a snapshot before a move and copied back after,
+ * instead of unmade, so the two can be timed against each
+ * other. The count is made on a copy; board is not touched
+ ***************************************************/
+uint64_t perftCopyMake(const Board & board, int depth);
+
+/***************************************************
+ * DIVIDE
+ * perft() broken down by root move: one "e2e4: 20" line
+ * per legal move, followed by the total
+ ***************************************************/
+uint64_t divide(Board & board, int depth, std::ostream & out);
+
+/***************************************************
+ * PERFT PARALLEL
+ * perft() with the subtrees shared out across numThreads
+ * threads. Each thread works on its own copy of the board.
+ * The root moves are split, and at depth 3 and deeper so
+ * are the replies to them, so the work divides evenly. If
+ * pNodesPerThread is given, it gets each thread's count
+ ***************************************************/
+uint64_t perftParallel(const Board & board, int depth, int numThreads,
+                       std::vector<uint64_t> * pNodesPerThread = nullptr);
@@ -0,0 +1,306 @@
+/**********************************************************************
+* Source File:
+*    Perft
+* Author:
+*    Chris Mijangos and Seth Chen
+* Summary:
+*    A console program that runs perft on the move generator, without
+*    opening a window. Use it to check node counts and to measure how
+*    many nodes per second the generator produces.
+*       perft [depth]              count depth 1 through depth
+*       perft [depth] divide       one line per root move at depth
+*       perft [depth] threads [n]  count on n threads, 0 for one per core
+*       perft [depth] hash [mb]    count each transposed subtree once, with
+*                                  an mb megabyte table, 64 if left off
+*       perft [depth] copymake     restore each position from a snapshot
+*                                  instead of unmaking the move
+*       perft magics               search for the magic numbers again
+*       perft epd [file] [threads [n]] [depth [d]] [search [d]] [time [ms]]
+*                                  check every position of an EPD suite,
+*                                  perft counts no deeper than d, and bm
+*                                  and am with a search of d plies or ms
+*       perft search [depth] [time [ms]] [hash [mb]] [threads [n]]
+*                                  search for the best move, printing
+*                                  each iteration as it finishes, with
+*                                  an mb megabyte transposition table
+*                                  shared by n threads
+*       perft speedup [depth] [threads [n]] [hash [mb]]
+*                                  time a search to depth on 1, 2, 4, ...
+*                                  n threads, for the speedup of each
+*    Any of the counts can end with "slider magic" or "slider pext" to
+*    force how the rook and bishop tables are read, for benchmarking,
+*    and before that with fen "..." to count from another position.
+************************************************************************/
+
+#include "board.h"        // for BOARD
+#include "perft.h"        // for PERFT and DIVIDE
+#include "magic.h"        // for the slider tables and their startup time
+#include "epd.h"          // for EPDSUITE
+#include "search.h"       // for SEARCH
+#include <chrono>         // for timing the run
+#include <cstdlib>        // for ATOI
+#include <cstring>        // for STRCMP
+#include <fstream>        // for IFSTREAM
+#include <iostream>
+#include <thread>         // for HARDWARE_CONCURRENCY
+#include <vector>
+using namespace std;
+
+/*********************************
+ * RUN EPD
+ * Check a suite of positions across the threads
+ *********************************/
+static int runEpd(int argc, char** argv)
+{
+   ifstream fin(argv[2]);
+   if (!fin)
+   {
+      cerr << "cannot open " << argv[2] << "\n";
+      return 1;
+   }
+
+   EpdSuite suite;
+   SearchLimits limits(5 /*depth*/);
+   int numThreads = 0;
+   for (int i = 3; i + 1 < argc; i += 2)
+   {
+      if (strcmp(argv[i], "threads") == 0)
+         numThreads = atoi(argv[i + 1]);
+      else if (strcmp(argv[i], "depth") == 0)
+         suite.setMaxDepth(atoi(argv[i + 1]));
+      else if (strcmp(argv[i], "search") == 0)
+         limits.depth = atoi(argv[i + 1]);
+      else if (strcmp(argv[i], "time") == 0)
+      {
+         limits.milliseconds = atoi(argv[i + 1]);
+         limits.depth = 0;
+      }
+   }
+   suite.setSearchLimits(limits);
+
+   suite.read(fin);
+   suite.run(numThreads);
+   suite.display(cout);
+   suite.report();
+   for (const EpdResult & result : suite.getResults())
+      if (result.status == EpdResult::FAIL)
+         return 1;
+   return 0;
+}
+
+/*********************************
+ * RUN SEARCH
+ * Think about the position, to a depth or for a time
+ *********************************/
+static int runSearch(Board & board, int argc, char** argv)
+{
+   SearchLimits limits(argc > 2 ? atoi(argv[2]) : 0);
+   size_t hashMegabytes = Search::DEFAULT_TABLE_MB;
+   int numThreads = 1;
+   for (int i = 3; i + 1 < argc; i += 2)
+   {
+      if (strcmp(argv[i], "time") == 0)
+         limits.milliseconds = atoi(argv[i + 1]);
+      else if (strcmp(argv[i], "hash") == 0 && atoi(argv[i + 1]) > 0)
+         hashMegabytes = (size_t)atoi(argv[i + 1]);
+      else if (strcmp(argv[i], "threads") == 0)
+         numThreads = atoi(argv[i + 1]);
+   }
+   if (limits.depth <= 0 && limits.milliseconds <= 0)
+      limits.depth = 6;
+
+   TranspositionTable table(hashMegabytes);
+   Search search(table);
+   search.setNumThreads(numThreads);
+   cout << "hash " << table.getMegabytes() << " MB, "
+        << table.getNumEntries() << " entries"
+        << "\tthreads " << search.getNumThreads() << endl;
+   SearchResult result = search.think(board, limits, &cout);
+   cout << "bestmove " << result.bestMove.getLongAlgebraic() << endl;
+   return 0;
+}
+
+/*********************************
+ * RUN SPEEDUP
+ * Time-to-depth on 1, 2, 4, ... threads, each count
+ * searching the same positions to the same depth
+ * from an empty table, against the time on one thread
+ *********************************/
+static int runSpeedup(int argc, char** argv)
+{
+   static const char * POSITIONS[] =
+   {
+      "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+      "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+      "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"
+   };
+
+   int depth = (argc > 2 && atoi(argv[2]) > 0) ? atoi(argv[2]) : 8;
+   int maxThreads = (int)thread::hardware_concurrency();
+   size_t hashMegabytes = 256;
+   for (int i = 3; i + 1 < argc; i += 2)
+   {
+      if (strcmp(argv[i], "threads") == 0 && atoi(argv[i + 1]) > 0)
+         maxThreads = atoi(argv[i + 1]);
+      else if (strcmp(argv[i], "hash") == 0 && atoi(argv[i + 1]) > 0)
+         hashMegabytes = (size_t)atoi(argv[i + 1]);
+   }
+   if (maxThreads < 1)
+      maxThreads = 1;
+
+   TranspositionTable table(hashMegabytes);
+   cout << "depth " << depth << "\thash " << table.getMegabytes() << " MB"
+        << "\tpositions " << sizeof(POSITIONS) / sizeof(POSITIONS[0]) << endl;
+
+   // the powers of two, ending on the largest count asked for
+   vector<int> counts;
+   for (int numThreads = 1; numThreads < maxThreads; numThreads *= 2)
+      counts.push_back(numThreads);
+   counts.push_back(maxThreads);
+
+   double secondsOne = 0.0;
+   for (int numThreads : counts)
+   {
+      double seconds = 0.0;
+      uint64_t nodes = 0;
+      for (const char * fen : POSITIONS)
+      {
+         Board board;
+         board.loadFEN(fen);
+         table.clear();
+         Search search(table);
+         search.setNumThreads(numThreads);
+         SearchResult result = search.think(board, SearchLimits(depth));
+         seconds += result.seconds;
+         nodes   += result.nodes;
+      }
+      if (numThreads == 1)
+         secondsOne = seconds;
+      cout << "threads " << numThreads
+           << "\ttime " << seconds << "s"
+           << "\tspeedup " << (seconds > 0.0 ? secondsOne / seconds : 0.0)
+           << "\tnodes " << nodes
+           << "\tnps " << (seconds > 0.0 ? (uint64_t)(nodes / seconds) : 0)
+           << endl;
+   }
+   return 0;
+}
+
+/*********************************
+ * MAIN
+ * Count the nodes from the starting position
+ *********************************/
+int main(int argc, char** argv)
+{
+   if (argc > 1 && strcmp(argv[1], "magics") == 0)
+   {
+      printMagics(cout);
+      return 0;
+   }
+   if (argc > 2 && strcmp(argv[1], "epd") == 0)
+      return runEpd(argc, argv);
+   if (argc > 1 && strcmp(argv[1], "speedup") == 0)
+      return runSpeedup(argc, argv);
+
+   // the slider backend is picked at startup unless forced
+   if (argc > 2 && strcmp(argv[argc - 2], "slider") == 0)
+   {
+      bool isPext = strcmp(argv[argc - 1], "pext") == 0;
+      if (!isPext && strcmp(argv[argc - 1], "magic") != 0)
+      {
+         cerr << "slider must be magic or pext\n";
+         return 1;
+      }
+      if (!setSliderBackend(isPext ? SLIDER_PEXT : SLIDER_MAGIC))
+      {
+         cerr << "this processor has no PEXT instruction\n";
+         return 1;
+      }
+      argc -= 2;
+   }
+
+   // start somewhere other than the starting position
+   const char * fen = nullptr;
+   if (argc > 2 && strcmp(argv[argc - 2], "fen") == 0)
+   {
+      fen = argv[argc - 1];
+      argc -= 2;
+   }
+
+   bool isSearch = (argc > 1 && strcmp(argv[1], "search") == 0);
+   int depth = isSearch ? 1 : (argc > 1) ? atoi(argv[1]) : 5;
+   bool isDivide = (argc > 2 && strcmp(argv[2], "divide") == 0);
+   bool isCopyMake = (argc > 2 && strcmp(argv[2], "copymake") == 0);
+   size_t hashMegabytes = 0;
+   if (argc > 2 && strcmp(argv[2], "hash") == 0)
+      hashMegabytes = (argc > 3 && atoi(argv[3]) > 0) ? (size_t)atoi(argv[3]) : 64;
+   int numThreads = 1;
+   if (argc > 2 && strcmp(argv[2], "threads") == 0)
+   {
+      numThreads = (argc > 3) ? atoi(argv[3]) : 0;
+      if (numThreads <= 0)
+         numThreads = (int)thread::hardware_concurrency();
+      if (numThreads <= 0)
+         numThreads = 1;
+   }
+   if (depth < 1)
+   {
+      cerr << "usage: " << argv[0] << " [depth] [divide | hash [mb] | copymake | threads [n]] [fen \"...\"] [slider magic | pext] | search [depth] [time [ms]] [hash [mb]] [threads [n]] | speedup [depth] [threads [n]] [hash [mb]] | magics | epd [file] [threads [n]] [depth [d]] [search [d]] [time [ms]]\n";
+      return 1;
+   }
+
+   Board board;
+   if (fen && !board.loadFEN(fen))
+   {
+      cerr << "not a legal FEN: " << fen << "\n";
+      return 1;
+   }
+   cout << "slider tables built in " << magicInitMicroseconds() / 1000.0 << "ms"
+        << "\tslider " << sliderBackendName(SLIDER_BACKEND)
+        << (hasFastPext() ? "" : " (no fast pext)")
+        << "\t" << (isCopyMake ? "copy-make" : "make/unmake")
+        << " (snapshot " << sizeof(BoardSnapshot) << " bytes)" << endl;
+
+   if (isSearch)
+      return runSearch(board, argc, argv);
+   if (isDivide)
+   {
+      divide(board, depth, cout);
+      return 0;
+   }
+
+   PerftHash hash(hashMegabytes ? hashMegabytes : 1);
+   if (hashMegabytes)
+      cout << "hash " << hash.getNumEntries() << " entries" << endl;
+
+   vector<uint64_t> nodesPerThread;
+   for (int d = 1; d <= depth; d++)
+   {
+      uint64_t numProbes = hash.getNumProbes();
+      uint64_t numHits   = hash.getNumHits();
+      auto begin = chrono::steady_clock::now();
+      uint64_t nodes = (numThreads > 1) ? perftParallel(board, d, numThreads, &nodesPerThread) :
+                       hashMegabytes    ? perft(board, d, hash) :
+                       isCopyMake       ? perftCopyMake(board, d) : perft(board, d);
+      auto end = chrono::steady_clock::now();
+
+      double seconds = chrono::duration<double>(end - begin).count();
+      cout << "depth " << d
+           << "\tnodes " << nodes
+           << "\ttime " << seconds << "s"
+           << "\tnps " << (seconds > 0.0 ? (uint64_t)(nodes / seconds) : 0);
+      if (hashMegabytes && hash.getNumProbes() > numProbes)
+         cout << "\thash hits "
+              << 100.0 * (hash.getNumHits() - numHits) / (hash.getNumProbes() - numProbes) << "%";
+      cout << endl;
+   }
+
+   // how evenly the deepest count was shared out
+   if (numThreads > 1)
+   {
+      for (size_t i = 0; i < nodesPerThread.size(); i++)
+         cout << "thread " << i << "\tnodes " << nodesPerThread[i] << endl;
+   }
+   return 0;
+}
@@ -37,10 +37,46 @@ const Piece & Piece::operator = (const Piece & rhs)
 
 /************************************************
  * PIECE : GET MOVES
- * Iterate through the moves decorator to allow a piece to move
+ * Collect the moves into a set. The pieces generate
+ * into a MoveList; this is for callers that want a std::set
  ***********************************************/
 void Piece::getMoves(set <Move> & movesSet, const Board & board) const
 {
+   MoveList moves;
+   getMoves(moves, board);
+   for (const PackedMove & move : moves)
+   {
+      PieceType capture = SPACE;
+      if (move.isEnPassant())
+         capture = PAWN;
+      else if (move.isCapture())
+         capture = board[Position(move.getTo())].getType();
+      movesSet.insert(move.getMove(capture));
+   }
+}
+
+/************************************************
+ * PIECE : GET MOVES
+ * A piece that cannot move has no moves
+ ***********************************************/
+void Piece::getMoves(MoveList & moves, const Board & board) const
+{
+}
 
-    
+/************************************************
+ * PIECE : ADD TARGETS
+ * Walk a set of target squares from an attack table.
+ * An empty square is a move, an opponent a capture
+ ***********************************************/
+void Piece::addTargets(MoveList & moves, const Board & board, Bitboard targets) const
+{
+   while (targets)
+   {
+      Position pos(popLsb(targets));
+      const Piece & piece = board[pos];
+      if (piece.getType() == SPACE)
+         moves.add(PackedMove(position, pos));
+      else if (piece.isWhite() != fWhite)
+         moves.add(PackedMove(position, pos, PackedMove::CAPTURE));
+   }
 }
@@ -15,7 +15,9 @@
 #include <cassert>
 #include "position.h"  // Because Position is a member variable
 #include "move.h"      // Because we return a set of Move
+#include "moveList.h"  // Because we can also fill a MoveList
 #include "pieceType.h" // A piece type.
+#include "bitboard.h"  // for the attack-table targets
 using std::set;
 
 // forward declaration because one of the Piece methods takes a Board
@@ -81,12 +83,24 @@ public:
    }
    virtual void setPosition(const Position & pos) { position = pos; }
 
+   // hand this piece out again as if it were just constructed
+   void recycle(const Position & pos, bool isWhite)
+   {
+      position = pos;
+      fWhite   = isWhite;
+      nMoves   = 0;
+      lastMove = 0;
+   }
+
    // overwritten by the various pieces
    virtual PieceType getType()                                    const = 0;
    virtual void display(ogstream * pgout)                         const = 0;
    virtual void getMoves(set <Move> & moves, const Board & board) const;
+   virtual void getMoves(MoveList & moves, const Board & board) const;
 
 protected:
+   // a move to each target that is empty or holds an opponent
+   void addTargets(MoveList & moves, const Board & board, Bitboard targets) const;
   
    int  nMoves;                    // how many times have you moved?
    bool fWhite;                    // which team are you on?
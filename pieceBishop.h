@@ -6,7 +6,8 @@ class Bishop : public Piece
 public:
     Bishop(int col, int row, bool isWhite);
     PieceType getType() const override { return BISHOP; }
-    void getMoves(set<Move>& moves, const Board& board) const;
+    using Piece::getMoves;
+    void getMoves(MoveList& moves, const Board& board) const override;
     void display(ogstream* pgout) const override;
 };
 
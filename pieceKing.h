@@ -7,10 +7,11 @@ class King : public Piece
 public:
     King(int col, int row, bool isWhite);
     PieceType getType() const override { return KING; }
-    void getMoves(set<Move>& moves, const Board& board) const;
+    using Piece::getMoves;
+    void getMoves(MoveList& moves, const Board& board) const override;
     void display(ogstream* pgout) const override;
 
 private:
     bool canCastle(const Board& board, bool kingSide) const;
-    void addCastlingMoves(set<Move>& moves, const Board& board) const;
+    void addCastlingMoves(MoveList& moves, const Board& board) const;
 };
\ No newline at end of file
@@ -9,6 +9,7 @@
 
 #include "pieceKnight.h"
 #include "board.h"
+#include "attacks.h"
 #include "uiDraw.h"    // for draw*()
 
  /***************************************************
@@ -24,35 +25,7 @@ void Knight::display(ogstream* pgout) const
 /**********************************************
  * KNIGHT : GET POSITIONS
  *********************************************/
-void Knight::getMoves(set<Move>& moves, const Board& board) const
+void Knight::getMoves(MoveList& moves, const Board& board) const
 {
-    const int knightMoves[8][2] = {
-        {2, 1}, {2, -1}, {-2, 1}, {-2, -1},
-        {1, 2}, {1, -2}, {-1, 2}, {-1, -2}
-    };
-
-    for (const auto& move : knightMoves)
-    {
-        int newRow = this->position.getRow() + move[1];
-        int newCol = this->position.getCol() + move[0];
-
-        if (newRow >= 0 && newRow < 8 && newCol >= 0 && newCol < 8)
-        {
-            Position pos(newCol, newRow);
-            Move newMove(this->position, pos);
-
-            if (board[pos].getType() == SPACE)
-            {
-                // Empty square, regular move
-                newMove.setCapture(SPACE);
-                moves.insert(newMove);
-            }
-            else if (board[pos].isWhite() != this->fWhite)
-            {
-                // Opposite color piece, capture move
-                newMove.setCapture(board[pos].getType());
-                moves.insert(newMove);
-            }
-        }
-    }
+    addTargets(moves, board, knightAttacks(position.getLocation()));
 }
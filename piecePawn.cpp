@@ -5,7 +5,7 @@
 
 Pawn::Pawn(int col, int row, bool isWhite) : Piece(col, row, isWhite) {}
 
-void Pawn::getMoves(set<Move>& moves, const Board& board) const
+void Pawn::getMoves(MoveList& moves, const Board& board) const
 {
     int direction = isWhite() ? 1 : -1;
     Position forward(position, Delta{ direction, 0 });
@@ -16,12 +16,12 @@ void Pawn::getMoves(set<Move>& moves, const Board& board) const
     // Forward move
     if (forward.isValid() && board[forward].getType() == SPACE)
     {
-        addMove(moves, forward, SPACE, board);
+        addMove(moves, forward, SPACE);
         // Initial double move
         int startingRank = isWhite() ? 1 : 6;
         if (position.getRow() == startingRank && forwardTwo.isValid() && board[forwardTwo].getType() == SPACE)
         {
-            addMove(moves, forwardTwo, SPACE, board);
+            addMove(moves, forwardTwo, SPACE);
         }
     }
 
@@ -30,26 +30,23 @@ void Pawn::getMoves(set<Move>& moves, const Board& board) const
     addCaptureMove(moves, captureRight, board);
 }
 
-void Pawn::addCaptureMove(set<Move>& moves, const Position& capturePos, const Board& board) const
+void Pawn::addCaptureMove(MoveList& moves, const Position& capturePos, const Board& board) const
 {
     if (capturePos.isValid())
     {
         const Piece& pieceAtCapture = board[capturePos];
         if (pieceAtCapture.getType() != SPACE && pieceAtCapture.isWhite() != isWhite())
         {
-            addMove(moves, capturePos, pieceAtCapture.getType(), board);
+            addMove(moves, capturePos, pieceAtCapture.getType());
         }
         else if (canEnPassant(capturePos, board))
         {
-            Move enPassant(position, capturePos);
-            enPassant.setCapture(PAWN);
-            enPassant.setMoveType("ENPASSANT");
-            moves.insert(enPassant);
+            moves.add(PackedMove(position, capturePos, PackedMove::ENPASSANT));
         }
     }
 }
 
-void Pawn::addMove(set<Move>& moves, const Position& newPos, PieceType capture, const Board& board) const
+void Pawn::addMove(MoveList& moves, const Position& newPos, PieceType capture) const
 {
     if ((isWhite() && newPos.getRow() == 7) || (!isWhite() && newPos.getRow() == 0))
     {
@@ -57,21 +54,16 @@ void Pawn::addMove(set<Move>& moves, const Position& newPos, PieceType capture,
     }
     else
     {
-        Move move(position, newPos);
-        move.setCapture(capture);
-        moves.insert(move);
+        moves.add(PackedMove(position, newPos, capture == SPACE ? PackedMove::QUIET : PackedMove::CAPTURE));
     }
 }
 
-void Pawn::addPromotionMoves(set<Move>& moves, const Position& newPos, PieceType capture) const
+void Pawn::addPromotionMoves(MoveList& moves, const Position& newPos, PieceType capture) const
 {
     const PieceType promotions[] = { QUEEN, ROOK, BISHOP, KNIGHT };
     for (PieceType promotion : promotions)
     {
-        Move move(position, newPos);
-        move.setCapture(capture);
-        move.setPromotionPiece(promotion);
-        moves.insert(move);
+        moves.add(PackedMove(position, newPos, PackedMove::promoteFlag(promotion, capture != SPACE)));
     }
 }
 
@@ -6,13 +6,14 @@ class Pawn : public Piece
 public:
     Pawn(int col, int row, bool isWhite);
     PieceType getType() const override { return PAWN; }
-    void getMoves(set<Move>& moves, const Board& board) const;
+    using Piece::getMoves;
+    void getMoves(MoveList& moves, const Board& board) const override;
     void display(ogstream* pgout) const override;
 
 private:
-    void addMove(set<Move>& moves, const Position& newPos, PieceType capture, const Board& board) const;
-    void addPromotionMoves(set<Move>& moves, const Position& newPos, PieceType capture) const;
+    void addMove(MoveList& moves, const Position& newPos, PieceType capture) const;
+    void addPromotionMoves(MoveList& moves, const Position& newPos, PieceType capture) const;
     bool canEnPassant(const Position& newPos, const Board& board) const;
-    void addCaptureMove(set<Move>& moves, const Position& capturePos, const Board& board) const;
+    void addCaptureMove(MoveList& moves, const Position& capturePos, const Board& board) const;
 };
 
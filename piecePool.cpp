@@ -0,0 +1,112 @@
+/***********************************************************************
+ * Source File:
+ *    PIECE POOL
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    Typed free lists of pieces so a Board can stop asking the heap
+ *    for every Space, promotion and re-created capture
+ ************************************************************************/
+
+#include "piecePool.h"
+#include "piece.h"
+#include "pieceSpace.h"
+#include "pieceKing.h"
+#include "pieceQueen.h"
+#include "pieceRook.h"
+#include "pieceBishop.h"
+#include "pieceKnight.h"
+#include "piecePawn.h"
+#include <cassert>
+#include <typeinfo>    // for TYPEID
+using namespace std;
+
+/************************************************
+ * IS RECYCLABLE
+ * Only a plain piece goes on a list. The tests dress
+ * up doubles as pieces; those are simply deleted
+ ***********************************************/
+static bool isRecyclable(const Piece & piece)
+{
+   switch (piece.getType())
+   {
+      case SPACE:  return typeid(piece) == typeid(Space);
+      case KING:   return typeid(piece) == typeid(King);
+      case QUEEN:  return typeid(piece) == typeid(Queen);
+      case ROOK:   return typeid(piece) == typeid(Rook);
+      case BISHOP: return typeid(piece) == typeid(Bishop);
+      case KNIGHT: return typeid(piece) == typeid(Knight);
+      case PAWN:   return typeid(piece) == typeid(Pawn);
+      default:     return false;
+   }
+}
+
+/************************************************
+ * PIECE POOL : DESTRUCT
+ * Everything waiting on a list goes back to the heap
+ ***********************************************/
+PiecePool::~PiecePool()
+{
+   for (int pt = 0; pt < 8; pt++)
+      for (int i = 0; i < numFree[pt]; i++)
+         delete freeList[pt][i];
+}
+
+/************************************************
+ * PIECE POOL : ACQUIRE
+ * Take the last piece put on the type's list, or
+ * make a new one when the list is empty
+ ***********************************************/
+Piece * PiecePool::acquire(PieceType pt, int c, int r, bool isWhite)
+{
+   if (numFree[pt] > 0)
+   {
+      numRecycled++;
+      Piece * pPiece = freeList[pt][--numFree[pt]];
+      pPiece->recycle(Position(c, r), isWhite);
+      return pPiece;
+   }
+
+   numAllocated++;
+   switch (pt)
+   {
+      case KING:   return new King  (c, r, isWhite);
+      case QUEEN:  return new Queen (c, r, isWhite);
+      case ROOK:   return new Rook  (c, r, isWhite);
+      case BISHOP: return new Bishop(c, r, isWhite);
+      case KNIGHT: return new Knight(c, r, isWhite);
+      case PAWN:   return new Pawn  (c, r, isWhite);
+      default:     return new Space (c, r);
+   }
+}
+
+/************************************************
+ * PIECE POOL : RELEASE
+ * Put a piece on its type's list, if there is room
+ ***********************************************/
+void PiecePool::release(Piece * pPiece)
+{
+   if (pPiece == nullptr)
+      return;
+   numReleased++;
+
+   PieceType pt = pPiece->getType();
+   if (isRecyclable(*pPiece) && numFree[pt] < CAPACITY)
+      freeList[pt][numFree[pt]++] = pPiece;
+   else
+   {
+      numDeleted++;
+      delete pPiece;
+   }
+}
+
+/************************************************
+ * PIECE POOL : GET NUM FREE
+ ***********************************************/
+int PiecePool::getNumFree() const
+{
+   int count = 0;
+   for (int pt = 0; pt < 8; pt++)
+      count += numFree[pt];
+   return count;
+}
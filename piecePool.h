@@ -0,0 +1,57 @@
+/***********************************************************************
+ * Header File:
+ *    PIECE POOL
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    A place for a Board to keep the Piece objects it is done with,
+ *    one list per PieceType, so the next Space, Queen or re-created
+ *    capture comes off a list instead of the heap. Each Board has its
+ *    own pool, so boards on different threads never share a lock.
+ ************************************************************************/
+
+#pragma once
+
+#include "pieceType.h"   // for PIECETYPE
+
+class Piece;
+class TestPiecePool;
+
+/***************************************************
+ * PIECE POOL
+ * Typed free lists of pieces, with counters
+ ***************************************************/
+class PiecePool
+{
+   friend TestPiecePool;
+public:
+   // the most pieces of one type the pool keeps; more are deleted
+   static const int CAPACITY = 64;
+
+   PiecePool() : numFree(), numAllocated(0), numRecycled(0), numReleased(0), numDeleted(0) { }
+   ~PiecePool();
+   PiecePool(const PiecePool & rhs)              = delete;
+   PiecePool & operator = (const PiecePool & rhs) = delete;
+
+   // a piece of the given type, as if just constructed
+   Piece * acquire(PieceType pt, int c, int r, bool isWhite);
+
+   // give a piece back. The pool now owns it
+   void release(Piece * pPiece);
+
+   // how the pieces have come and gone
+   int getNumAllocated() const { return numAllocated; }   // came from the heap
+   int getNumRecycled()  const { return numRecycled;  }   // came off a free list
+   int getNumReleased()  const { return numReleased;  }   // were given back
+   int getNumDeleted()   const { return numDeleted;   }   // went back to the heap
+   int getNumFree()      const;                           // wait on a free list now
+
+private:
+   Piece * freeList[8][CAPACITY];   // [PieceType] pieces ready to hand out
+   int     numFree[8];
+
+   int numAllocated;
+   int numRecycled;
+   int numReleased;
+   int numDeleted;
+};
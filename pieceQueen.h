@@ -6,7 +6,8 @@ class Queen : public Piece
 public:
     Queen(int col, int row, bool isWhite);
     PieceType getType() const override { return QUEEN; }
-    void getMoves(set<Move>& moves, const Board& board) const;
+    using Piece::getMoves;
+    void getMoves(MoveList& moves, const Board& board) const override;
     void display(ogstream* pgout) const override;
 };
 
@@ -6,7 +6,8 @@ class Rook : public Piece
 public:
     Rook(int col, int row, bool isWhite);
     PieceType getType() const override { return ROOK; }
-    void getMoves(set<Move>& moves, const Board& board) const;
+    using Piece::getMoves;
+    void getMoves(MoveList& moves, const Board& board) const override;
     void display(ogstream* pgout) const override;
 };
 
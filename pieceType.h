@@ -4,10 +4,34 @@
  * Author:
  *    Br. Helfrich
  * Summary:
- *    Just an enumeration of a piece type. Nothing fancy
+ *    Just an enumeration of a piece type, and the one-byte code the
+ *    board keeps on each square: the type and the color together
  ************************************************************************/
 
 
 #pragma once
 
-enum PieceType { INVALID, SPACE, KING, QUEEN, ROOK, BISHOP, KNIGHT, PAWN };
\ No newline at end of file
+enum PieceType { INVALID, SPACE, KING, QUEEN, ROOK, BISHOP, KNIGHT, PAWN };
+
+/***************************************************
+ * PIECE CODE
+ * A piece in one byte: the PieceType in the low three
+ * bits, with BLACK_PIECE added for black. An empty square
+ * is a white SPACE, just as a Space piece is white
+ ***************************************************/
+typedef unsigned char PieceCode;
+constexpr PieceCode BLACK_PIECE = 8;
+constexpr PieceCode NO_PIECE    = SPACE;
+
+constexpr PieceCode pieceCode(PieceType pt, bool isWhite)
+{
+   return (PieceCode)(pt | (isWhite ? 0 : BLACK_PIECE));
+}
+constexpr PieceType typeOf(PieceCode code)      { return (PieceType)(code & 7);  }
+constexpr bool      isWhiteCode(PieceCode code) { return !(code & BLACK_PIECE); }
+
+/***************************************************
+ * PIECE VALUES
+ * In centipawns, by PieceType. The king is never traded
+ ***************************************************/
+inline constexpr int PIECE_VALUES[8] = { 0, 0, 0, 900, 500, 330, 320, 100 };
@@ -10,6 +10,10 @@
 #include "position.h"
 #include <iostream>
 
+// how big a square is drawn, changed when the window is resized
+double Position::squareWidth  = (double)SIZE_SQUARE;
+double Position::squareHeight = (double)SIZE_SQUARE;
+
 Position::Position(int location) : colRow(0xff)
 {
     if (location >= 0 && location < 64)
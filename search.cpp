@@ -0,0 +1,626 @@
+/***********************************************************************
+ * Source File:
+ *    SEARCH
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    Iterative-deepening alpha-beta search and the evaluation it uses
+ ************************************************************************/
+
+#include "search.h"
+#include "board.h"
+#include "movePicker.h"
+#include "pieceType.h" // for PIECE_VALUES
+#include <cassert>
+#include <cstdlib>     // for abs()
+#include <iostream>
+#include <thread>
+using namespace std;
+
+/***************************************************
+ * PIECE SQUARE TABLES
+ * What each square is worth to each piece, from white's
+ * side of the board, drawn rank 8 first so they read
+ * like a diagram
+ ***************************************************/
+static const int PAWN_TABLE[64] =
+{
+    0,  0,  0,  0,  0,  0,  0,  0,
+   50, 50, 50, 50, 50, 50, 50, 50,
+   10, 10, 20, 30, 30, 20, 10, 10,
+    5,  5, 10, 25, 25, 10,  5,  5,
+    0,  0,  0, 20, 20,  0,  0,  0,
+    5, -5,-10,  0,  0,-10, -5,  5,
+    5, 10, 10,-20,-20, 10, 10,  5,
+    0,  0,  0,  0,  0,  0,  0,  0
+};
+
+static const int KNIGHT_TABLE[64] =
+{
+  -50,-40,-30,-30,-30,-30,-40,-50,
+  -40,-20,  0,  0,  0,  0,-20,-40,
+  -30,  0, 10, 15, 15, 10,  0,-30,
+  -30,  5, 15, 20, 20, 15,  5,-30,
+  -30,  0, 15, 20, 20, 15,  0,-30,
+  -30,  5, 10, 15, 15, 10,  5,-30,
+  -40,-20,  0,  5,  5,  0,-20,-40,
+  -50,-40,-30,-30,-30,-30,-40,-50
+};
+
+static const int BISHOP_TABLE[64] =
+{
+  -20,-10,-10,-10,-10,-10,-10,-20,
+  -10,  0,  0,  0,  0,  0,  0,-10,
+  -10,  0,  5, 10, 10,  5,  0,-10,
+  -10,  5,  5, 10, 10,  5,  5,-10,
+  -10,  0, 10, 10, 10, 10,  0,-10,
+  -10, 10, 10, 10, 10, 10, 10,-10,
+  -10,  5,  0,  0,  0,  0,  5,-10,
+  -20,-10,-10,-10,-10,-10,-10,-20
+};
+
+static const int ROOK_TABLE[64] =
+{
+    0,  0,  0,  0,  0,  0,  0,  0,
+    5, 10, 10, 10, 10, 10, 10,  5,
+   -5,  0,  0,  0,  0,  0,  0, -5,
+   -5,  0,  0,  0,  0,  0,  0, -5,
+   -5,  0,  0,  0,  0,  0,  0, -5,
+   -5,  0,  0,  0,  0,  0,  0, -5,
+   -5,  0,  0,  0,  0,  0,  0, -5,
+    0,  0,  0,  5,  5,  0,  0,  0
+};
+
+static const int QUEEN_TABLE[64] =
+{
+  -20,-10,-10, -5, -5,-10,-10,-20,
+  -10,  0,  0,  0,  0,  0,  0,-10,
+  -10,  0,  5,  5,  5,  5,  0,-10,
+   -5,  0,  5,  5,  5,  5,  0, -5,
+    0,  0,  5,  5,  5,  5,  0, -5,
+  -10,  5,  5,  5,  5,  5,  0,-10,
+  -10,  0,  5,  0,  0,  0,  0,-10,
+  -20,-10,-10, -5, -5,-10,-10,-20
+};
+
+static const int KING_TABLE[64] =
+{
+  -30,-40,-40,-50,-50,-40,-40,-30,
+  -30,-40,-40,-50,-50,-40,-40,-30,
+  -30,-40,-40,-50,-50,-40,-40,-30,
+  -30,-40,-40,-50,-50,-40,-40,-30,
+  -20,-30,-30,-40,-40,-30,-30,-20,
+  -10,-20,-20,-20,-20,-20,-20,-10,
+   20, 20,  0,  0,  0,  0, 20, 20,
+   20, 30, 10,  0,  0, 10, 30, 20
+};
+
+static const int KING_ENDGAME_TABLE[64] =
+{
+  -50,-40,-30,-20,-20,-30,-40,-50,
+  -30,-20,-10,  0,  0,-10,-20,-30,
+  -30,-10, 20, 30, 30, 20,-10,-30,
+  -30,-10, 30, 40, 40, 30,-10,-30,
+  -30,-10, 30, 40, 40, 30,-10,-30,
+  -30,-10, 20, 30, 30, 20,-10,-30,
+  -30,-30,  0,  0,  0,  0,-30,-30,
+  -50,-30,-30,-30,-30,-30,-30,-50
+};
+
+static const int * const PIECE_TABLES[8] =
+{
+   nullptr, nullptr, KING_TABLE, QUEEN_TABLE, ROOK_TABLE,
+   BISHOP_TABLE, KNIGHT_TABLE, PAWN_TABLE
+};
+
+/***************************************************
+ * EVALUATE
+ * Once the queens are off, or little else is left,
+ * the king should come out to the middle
+ ***************************************************/
+int evaluate(const Board & board)
+{
+   int material = 0;
+   for (int pt = QUEEN; pt <= KNIGHT; pt++)
+      material += PIECE_VALUES[pt] *
+                  popCount(board.getPieces((PieceType)pt, true) | board.getPieces((PieceType)pt, false));
+   bool isEndgame = !(board.getPieces(QUEEN, true) | board.getPieces(QUEEN, false)) ||
+                    material <= 2 * (900 + 330);
+
+   int score = 0;
+   for (int pt = KING; pt <= PAWN; pt++)
+   {
+      const int * table = (pt == KING && isEndgame) ? KING_ENDGAME_TABLE : PIECE_TABLES[pt];
+      for (Bitboard white = board.getPieces((PieceType)pt, true); white; )
+         score += PIECE_VALUES[pt] + table[popLsb(white) ^ 56];
+      for (Bitboard black = board.getPieces((PieceType)pt, false); black; )
+         score -= PIECE_VALUES[pt] + table[popLsb(black)];
+   }
+   return (board.getCurrentMove() % 2 == 0) ? score : -score;
+}
+
+/***************************************************
+ * MATERIAL GAIN
+ ***************************************************/
+int materialGain(const Board & board, const PackedMove & move)
+{
+   int gain = 0;
+   if (move.isEnPassant())
+      gain = PIECE_VALUES[PAWN];
+   else if (move.isCapture())
+      gain = PIECE_VALUES[board.getPieceType(move.getTo())];
+   if (move.isPromotion())
+      gain += PIECE_VALUES[move.getPromotion()] - PIECE_VALUES[PAWN];
+   return gain;
+}
+
+/***************************************************
+ * DELTA MARGIN
+ * How much the piece-square tables can add on top of
+ * the material a capture wins. A capture that cannot
+ * bring the score up to alpha even with this much more
+ * is not worth searching
+ ***************************************************/
+static const int DELTA_MARGIN = 200;
+
+/***************************************************
+ * SEARCH : CONSTRUCTORS
+ * With a table of its own, or sharing one
+ ***************************************************/
+Search::Search() : pOwnTable(new TranspositionTable(DEFAULT_TABLE_MB)),
+   numThreads(1), isStopped(false), nodes(0), nodesReported(0), canStop(false)
+{
+   pTable = pOwnTable.get();
+   for (ButterflyHistory & side : history)
+      for (auto & from : side)
+         for (int & score : from)
+            score = 0;
+}
+
+Search::Search(TranspositionTable & table) : pTable(&table),
+   numThreads(1), isStopped(false), nodes(0), nodesReported(0), canStop(false)
+{
+   for (ButterflyHistory & side : history)
+      for (auto & from : side)
+         for (int & score : from)
+            score = 0;
+}
+
+/***************************************************
+ * SEARCH : SET NUM THREADS
+ * 0 for one per core
+ ***************************************************/
+void Search::setNumThreads(int numThreads)
+{
+   if (numThreads <= 0)
+      numThreads = (int)thread::hardware_concurrency();
+   this->numThreads = (numThreads < 1) ? 1 : numThreads;
+}
+
+/***************************************************
+ * SEARCH : CLEAR
+ * An empty table and no history, as if just built
+ ***************************************************/
+void Search::clear()
+{
+   pTable->clear();
+   gameKeys.clear();
+   for (ButterflyHistory & side : history)
+      for (auto & from : side)
+         for (int & score : from)
+            score = 0;
+}
+
+/***************************************************
+ * SCORE TO TABLE, SCORE FROM TABLE
+ * A mate is scored by its distance from the root, but
+ * the same position can be found at another ply, so the
+ * table keeps the distance from the position instead
+ ***************************************************/
+static int scoreToTable(int score, int ply)
+{
+   if (score >= SCORE_MATE - 1000)
+      return score + ply;
+   if (score <= -SCORE_MATE + 1000)
+      return score - ply;
+   return score;
+}
+
+static int scoreFromTable(int score, int ply)
+{
+   if (score >= SCORE_MATE - 1000)
+      return score - ply;
+   if (score <= -SCORE_MATE + 1000)
+      return score + ply;
+   return score;
+}
+
+/***************************************************
+ * SEARCH : THINK
+ * Lazy SMP: the helpers search the same position on
+ * threads of their own, with nothing shared but the
+ * table. What they store there cuts off and orders this
+ * thread's search, and they stop when it is done
+ ***************************************************/
+SearchResult Search::think(Board & board, const SearchLimits & limits,
+                           ostream * pInfo)
+{
+   pTable->newSearch();
+   start = chrono::steady_clock::now();
+   isStopped = false;
+
+   BoardSnapshot snapshot = board.getSnapshot();
+   vector<thread> threads;
+   for (int i = 1; i < numThreads; i++)
+   {
+      helpers.emplace_back(new Search(*pTable));
+      Search * pHelper = helpers.back().get();
+      pHelper->start = start;
+      pHelper->gameKeys = gameKeys;
+      threads.emplace_back([pHelper, snapshot, i]() { pHelper->help(snapshot, i); });
+   }
+
+   SearchResult result = deepen(board, limits, 1 /*firstDepth*/, pInfo);
+
+   for (unique_ptr<Search> & pHelper : helpers)
+      pHelper->stop();
+   for (thread & t : threads)
+      t.join();
+   for (unique_ptr<Search> & pHelper : helpers)
+      result.nodes += pHelper->nodes;
+   helpers.clear();
+
+   result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+   return result;
+}
+
+/***************************************************
+ * SEARCH : HELP
+ * A helper runs on its own board until it is stopped.
+ * Every other helper starts a ply deeper, so the helpers
+ * are not all on the same iteration as the main thread
+ ***************************************************/
+void Search::help(const BoardSnapshot & snapshot, int id)
+{
+   Board board(snapshot);
+   deepen(board, SearchLimits(), 1 + id % 2, nullptr);
+}
+
+/***************************************************
+ * SEARCH : NODES SEARCHED
+ * By this thread and, as of their last report, the helpers
+ ***************************************************/
+uint64_t Search::getNodesSearched() const
+{
+   uint64_t total = nodes;
+   for (const unique_ptr<Search> & pHelper : helpers)
+      total += pHelper->nodesReported.load(memory_order_relaxed);
+   return total;
+}
+
+/***************************************************
+ * SEARCH : DEEPEN
+ * One iteration per depth. An iteration cut short by
+ * the limits is thrown away: its move may not have been
+ * compared with the others
+ ***************************************************/
+SearchResult Search::deepen(Board & board, const SearchLimits & limits,
+                            int firstDepth, ostream * pInfo)
+{
+   this->limits  = limits;
+   canStop       = false;
+   nodes         = 0;
+   nodesReported = 0;
+   lastPVLength  = 0;
+   clearOrdering();
+   board.setPrefetch(pTable);
+
+   SearchResult result;
+   result.score = SCORE_DRAW;
+   result.depth = 0;
+
+   int maxDepth = (limits.depth > 0 && limits.depth < MAX_PLY) ? limits.depth : MAX_PLY - 1;
+   for (int depth = firstDepth; depth <= maxDepth; depth++)
+   {
+      int score = negamax(board, depth, 0, -SCORE_INFINITE, SCORE_INFINITE);
+      if (isStopped && canStop)
+         break;
+      canStop = true;
+
+      result.score = score;
+      result.depth = depth;
+      result.pv.assign(pv[0], pv[0] + pvLength[0]);
+      result.bestMove = result.pv.empty() ? PackedMove() : result.pv[0];
+      lastPVLength = pvLength[0];
+      for (int i = 0; i < lastPVLength; i++)
+         lastPV[i] = pv[0][i];
+
+      if (pInfo)
+      {
+         double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+         uint64_t nodesSearched = getNodesSearched();
+         *pInfo << "depth " << depth;
+         if (isMateScore(score))
+            *pInfo << "\tmate " << (score > 0 ? (SCORE_MATE - score + 1) / 2 : -(SCORE_MATE + score) / 2);
+         else
+            *pInfo << "\tscore " << score;
+         *pInfo << "\tnodes " << nodesSearched
+                << "\ttime " << seconds << "s"
+                << "\tnps " << (seconds > 0.0 ? (uint64_t)(nodesSearched / seconds) : 0)
+                << "\thashfull " << pTable->getPermille()
+                << "\tpv";
+         for (const PackedMove & move : result.pv)
+            *pInfo << " " << move.getLongAlgebraic();
+         *pInfo << endl;
+      }
+
+      // nothing to choose between, or a mate that cannot be bettered
+      if (result.pv.empty() || (isMateScore(score) && SCORE_MATE - abs(score) <= depth))
+         break;
+   }
+
+   board.setPrefetch(nullptr);
+   result.nodes = nodes;
+   return result;
+}
+
+/***************************************************
+ * SEARCH : CHECK LIMITS
+ * Out of time or nodes? Only asked every so often,
+ * since reading the clock is not free
+ ***************************************************/
+bool Search::checkLimits()
+{
+   if (!canStop)
+      return false;
+   if (limits.nodes && nodes >= limits.nodes)
+      isStopped = true;
+   if (limits.milliseconds &&
+       chrono::steady_clock::now() - start >= chrono::milliseconds(limits.milliseconds))
+      isStopped = true;
+   return isStopped;
+}
+
+/***************************************************
+ * SEARCH : CLEAR ORDERING
+ * The killers belong to the position searched last and
+ * are forgotten. The history is still worth something
+ * in the next position, so it is only halved
+ ***************************************************/
+void Search::clearOrdering()
+{
+   for (PackedMove * killersAtPly : killers)
+      killersAtPly[0] = killersAtPly[1] = PackedMove();
+   for (ButterflyHistory & side : history)
+      for (auto & from : side)
+         for (int & score : from)
+            score /= 2;
+}
+
+/***************************************************
+ * SEARCH : REWARD QUIET
+ * A quiet move cut off: it becomes this ply's first
+ * killer, and its history goes up by more the deeper
+ * the search. Every quiet move tried before it failed,
+ * and their history goes down by as much. Each change
+ * shrinks as the score nears HISTORY_MAX, so a move
+ * that keeps cutting off levels off there
+ ***************************************************/
+void Search::rewardQuiet(const Board & board, const PackedMove & move, int depth, int ply,
+                         const MoveList & quietsTried)
+{
+   if (!(move == killers[ply][0]))
+   {
+      killers[ply][1] = killers[ply][0];
+      killers[ply][0] = move;
+   }
+
+   ButterflyHistory & side = history[board.getCurrentMove() % 2];
+   int bonus = depth * depth;
+   for (const PackedMove & quiet : quietsTried)
+   {
+      int change = (quiet == move) ? bonus : -bonus;
+      int & score = side[quiet.getFrom()][quiet.getTo()];
+      score += change - score * bonus / HISTORY_MAX;
+   }
+}
+
+/***************************************************
+ * SEARCH : IS REPETITION
+ * Has this position come up before, on the line being
+ * searched or in the game before it? Only every other
+ * ply can match, and never past a capture or pawn move
+ ***************************************************/
+bool Search::isRepetition(const Board & board, int ply) const
+{
+   int reach = board.getHalfmoveClock();
+   int numGame = (int)gameKeys.size();
+   for (int back = 4; back <= reach && back <= ply + numGame; back += 2)
+   {
+      uint64_t key = back <= ply ? keys[ply - back] : gameKeys[numGame + ply - back];
+      if (key == board.getKey())
+         return true;
+   }
+   return false;
+}
+
+/***************************************************
+ * SEARCH : NEGAMAX
+ * The score of the position to the side to move, as
+ * long as it falls between alpha and beta. A score at
+ * or above beta means the opponent would not allow it.
+ * A score from the table that falls outside the window
+ * ends the search here; one inside it is searched again
+ * so the principal variation comes out whole
+ ***************************************************/
+int Search::negamax(Board & board, int depth, int ply, int alpha, int beta)
+{
+   pvLength[ply] = 0;
+   keys[ply] = board.getKey();
+   if ((++nodes & 1023) == 0)
+   {
+      nodesReported.store(nodes, memory_order_relaxed);
+      checkLimits();
+   }
+   if (isStopped && canStop)
+      return SCORE_DRAW;
+
+   if (ply > 0 && (board.getHalfmoveClock() >= 100 || isRepetition(board, ply)))
+      return SCORE_DRAW;
+   if (depth <= 0 || ply >= MAX_PLY - 1)
+      return quiesce(board, ply, alpha, beta);
+
+   TTEntry entry;
+   PackedMove tableMove;
+   if (pTable->probe(board.getKey(), entry))
+   {
+      tableMove = entry.move;
+      int score = scoreFromTable(entry.score, ply);
+      if (ply > 0 && entry.depth >= depth &&
+          (((entry.bound & BOUND_LOWER) && score >= beta) ||
+           ((entry.bound & BOUND_UPPER) && score <= alpha)))
+         return score;
+   }
+
+   // the previous iteration's move at this ply, first if the
+   // table has lost this position
+   if (tableMove.isNull() && ply < lastPVLength)
+      tableMove = lastPV[ply];
+
+   MovePicker picker(board, tableMove, killers[ply][0], killers[ply][1],
+                     &history[board.getCurrentMove() % 2]);
+   MoveList quietsTried;
+   int numMoves = 0;
+   int alphaOriginal = alpha;
+   int best = -SCORE_INFINITE;
+   PackedMove bestMove;
+   for (PackedMove move = picker.next(); !move.isNull(); move = picker.next())
+   {
+      numMoves++;
+      bool isQuiet = !move.isCapture() && !move.isPromotion();
+      if (isQuiet)
+         quietsTried.add(move);
+      board.makeMove(move);
+      int score = -negamax(board, depth - 1, ply + 1, -beta, -alpha);
+      board.unmakeMove();
+      if (isStopped && canStop)
+         return SCORE_DRAW;
+
+      if (score > best)
+      {
+         best = score;
+         if (score > alpha)
+         {
+            alpha = score;
+            bestMove = move;
+            pv[ply][0] = move;
+            for (int i = 0; i < pvLength[ply + 1]; i++)
+               pv[ply][i + 1] = pv[ply + 1][i];
+            pvLength[ply] = pvLength[ply + 1] + 1;
+            if (alpha >= beta)
+            {
+               if (isQuiet)
+                  rewardQuiet(board, move, depth, ply, quietsTried);
+               break;
+            }
+         }
+      }
+   }
+   if (numMoves == 0)
+      return board.isKingAttacked(board.getCurrentMove() % 2 == 0) ? -SCORE_MATE + ply : SCORE_DRAW;
+
+   TTBound bound = (best >= beta) ? BOUND_LOWER : (best > alphaOriginal) ? BOUND_EXACT : BOUND_UPPER;
+   pTable->store(board.getKey(), bestMove, scoreToTable(best, ply), depth, bound);
+   return best;
+}
+
+/***************************************************
+ * SEARCH : QUIESCE
+ * Past the depth, only the captures and promotions are
+ * searched, so the score is never taken in the middle of
+ * an exchange. The side to move may stand pat on the
+ * evaluation instead of capturing, unless it is in
+ * check, when every move that gets out is searched
+ ***************************************************/
+int Search::quiesce(Board & board, int ply, int alpha, int beta)
+{
+   pvLength[ply] = 0;
+   if ((++nodes & 1023) == 0)
+   {
+      nodesReported.store(nodes, memory_order_relaxed);
+      checkLimits();
+   }
+   if (isStopped && canStop)
+      return SCORE_DRAW;
+
+   bool isInCheck = board.isKingAttacked(board.getCurrentMove() % 2 == 0);
+   if (ply >= MAX_PLY - 1)
+      return isInCheck ? SCORE_DRAW : evaluate(board);
+
+   int best = -SCORE_INFINITE;
+   int standPat = 0;
+   if (!isInCheck)
+   {
+      standPat = evaluate(board);
+      if (standPat >= beta)
+         return standPat;
+
+      // not even winning a queen would be enough
+      if (standPat + PIECE_VALUES[QUEEN] + DELTA_MARGIN <= alpha &&
+          !(board.getPieces(PAWN, board.getCurrentMove() % 2 == 0) &
+            (board.getCurrentMove() % 2 == 0 ? RANK_7 : RANK_2)))
+         return standPat;
+      best = standPat;
+      if (standPat > alpha)
+         alpha = standPat;
+   }
+
+   MoveList moves;
+   board.generateLegalMoves(moves, isInCheck ? GEN_ALL : GEN_CAPTURES);
+   if (isInCheck && moves.empty())
+      return -SCORE_MATE + ply;
+
+   // the biggest prize first, taken by the smallest piece
+   int scores[MoveList::CAPACITY];
+   for (int i = 0; i < moves.size(); i++)
+      scores[i] = mvvLva(board, moves[i]);
+   for (int i = 1; i < moves.size(); i++)
+      for (int j = i; j > 0 && scores[j] > scores[j - 1]; j--)
+      {
+         swap(scores[j], scores[j - 1]);
+         swap(moves[j], moves[j - 1]);
+      }
+
+   for (int i = 0; i < moves.size(); i++)
+   {
+      const PackedMove & move = moves[i];
+
+      // a capture that cannot reach alpha, or that loses material
+      // once the exchange on its square is over, is not searched
+      if (!isInCheck && (standPat + materialGain(board, move) + DELTA_MARGIN <= alpha ||
+                         !board.seeGE(move, 0)))
+         continue;
+
+      board.makeMove(move);
+      int score = -quiesce(board, ply + 1, -beta, -alpha);
+      board.unmakeMove();
+      if (isStopped && canStop)
+         return SCORE_DRAW;
+
+      if (score > best)
+      {
+         best = score;
+         if (score > alpha)
+         {
+            alpha = score;
+            pv[ply][0] = move;
+            for (int j = 0; j < pvLength[ply + 1]; j++)
+               pv[ply][j + 1] = pv[ply + 1][j];
+            pvLength[ply] = pvLength[ply + 1] + 1;
+            if (alpha >= beta)
+               break;
+         }
+      }
+   }
+   return best;
+}
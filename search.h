@@ -0,0 +1,162 @@
+/***********************************************************************
+ * Header File:
+ *    SEARCH
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    Choose a move for the side to move. The search looks one ply
+ *    deeper each iteration, alpha-beta negamax on the bitboards,
+ *    until it reaches the depth asked for or runs out of time or
+ *    nodes. The last complete iteration gives the move, its score
+ *    and the line of best play that follows (the principal variation).
+ ************************************************************************/
+
+#pragma once
+
+#include "movePacked.h"
+#include "moveList.h"
+#include "movePicker.h"
+#include "transposition.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <vector>
+
+class Board;
+struct BoardSnapshot;
+class TestSearch;
+
+/***************************************************
+ * SCORES
+ * In centipawns, from the side to move's point of view.
+ * A mate in n plies scores SCORE_MATE - n
+ ***************************************************/
+const int SCORE_DRAW     = 0;
+const int SCORE_MATE     = 31000;
+const int SCORE_INFINITE = 32000;
+
+inline bool isMateScore(int score)
+{
+   return score >= SCORE_MATE - 1000 || score <= -SCORE_MATE + 1000;
+}
+
+/***************************************************
+ * EVALUATE
+ * The position as it stands: material and where each
+ * piece stands, for the side to move
+ ***************************************************/
+int evaluate(const Board & board);
+
+/***************************************************
+ * MATERIAL GAIN
+ * What a move wins outright, before any recapture: the
+ * piece it takes, and what a pawn becomes if it promotes
+ ***************************************************/
+int materialGain(const Board & board, const PackedMove & move);
+
+/***************************************************
+ * SEARCH LIMITS
+ * When to stop. Any limit left at 0 does not apply
+ ***************************************************/
+struct SearchLimits
+{
+   int      depth;          // the last iteration, in plies
+   int      milliseconds;   // stop after this long
+   uint64_t nodes;          // stop after this many nodes
+
+   SearchLimits(int depth = 0, int milliseconds = 0, uint64_t nodes = 0)
+      : depth(depth), milliseconds(milliseconds), nodes(nodes) { }
+};
+
+/***************************************************
+ * SEARCH RESULT
+ * What the last complete iteration found
+ ***************************************************/
+struct SearchResult
+{
+   PackedMove bestMove;          // null when there is no legal move
+   int        score;             // for the side to move
+   int        depth;             // of the last complete iteration
+   uint64_t   nodes;             // searched in all the iterations
+   double     seconds;           // how long the search took
+   std::vector<PackedMove> pv;   // bestMove, then the expected replies
+};
+
+/***************************************************
+ * SEARCH
+ * Iterative-deepening alpha-beta. With more than one
+ * thread, think() starts a helper Search on each of the
+ * others, sharing the transposition table (Lazy SMP).
+ * The table may be the Search's own or shared with other
+ * Searches. stop() may be called from any thread
+ ***************************************************/
+class Search
+{
+   friend TestSearch;
+public:
+   static const int MAX_PLY = 64;
+   static const int DEFAULT_TABLE_MB = 16;
+   static const int HISTORY_MAX = 16384;   // no history score goes past this either way
+
+   Search();
+   explicit Search(TranspositionTable & table);
+
+   TranspositionTable & getTable() { return *pTable; }
+
+   // how many threads think() searches on, helpers included
+   void setNumThreads(int numThreads);
+   int  getNumThreads() const { return numThreads; }
+
+   // the keys of the positions played before the one think() is
+   // given, oldest first. A line that returns to one is a draw
+   void setGameKeys(const std::vector<uint64_t> & keys) { gameKeys = keys; }
+
+   // search the board's position. The board is left as found. If
+   // pInfo is given, each iteration is written to it as it finishes
+   SearchResult think(Board & board, const SearchLimits & limits,
+                      std::ostream * pInfo = nullptr);
+
+   // finish now, with the last complete iteration
+   void stop() { isStopped = true; }
+
+   // forget everything learned from earlier searches, and the
+   // game keys, as before a position unrelated to the last one
+   void clear();
+
+private:
+   SearchResult deepen(Board & board, const SearchLimits & limits,
+                       int firstDepth, std::ostream * pInfo);
+   void help(const BoardSnapshot & snapshot, int id);
+   uint64_t getNodesSearched() const;
+   int  negamax(Board & board, int depth, int ply, int alpha, int beta);
+   int  quiesce(Board & board, int ply, int alpha, int beta);
+   bool isRepetition(const Board & board, int ply) const;
+   bool checkLimits();
+   void rewardQuiet(const Board & board, const PackedMove & move, int depth, int ply,
+                    const MoveList & quietsTried);
+   void clearOrdering();
+
+   std::unique_ptr<TranspositionTable> pOwnTable;   // null when shared
+   TranspositionTable * pTable;
+   int numThreads;
+   std::vector<std::unique_ptr<Search>> helpers;   // only while thinking
+
+   std::atomic<bool> isStopped;
+   SearchLimits limits;
+   std::chrono::steady_clock::time_point start;
+   uint64_t nodes;
+   std::atomic<uint64_t> nodesReported;      // nodes, every 1024, for other threads
+   bool canStop;                             // false until depth 1 is done
+
+   PackedMove pv[MAX_PLY][MAX_PLY];          // pv[ply] is the line from ply on
+   int        pvLength[MAX_PLY];
+   PackedMove lastPV[MAX_PLY];               // the previous iteration's line
+   int        lastPVLength;
+   uint64_t   keys[MAX_PLY];                 // the key at each ply of this line
+   std::vector<uint64_t> gameKeys;           // the positions before the root
+
+   PackedMove killers[MAX_PLY][2];           // the last quiet moves to cut off at each ply
+   ButterflyHistory history[2];              // for white, then black
+};
@@ -14,6 +14,14 @@
 #include "testPosition.h"
 #include "testBoard.h"
 #include "testMove.h"
+#include "testMoveList.h"
+#include "testMovePacked.h"
+#include "testPerft.h"
+#include "testPiecePool.h"
+#include "testEpd.h"
+#include "testSearch.h"
+#include "testTransposition.h"
+#include "testMovePicker.h"
 #include "testBishop.h"
 #include "testRook.h"
 #include "testKing.h"
@@ -56,7 +64,15 @@ void testRunner()
    // unit tests
    PositionTest().run();
    TestMove().run();
+   TestPackedMove().run();
+   TestMoveList().run();
    TestBoard().run();
+   TestPerft().run();
+   TestPiecePool().run();
+   TestEpd().run();
+   TestTransposition().run();
+   TestMovePicker().run();
+   TestSearch().run();
    TestPiece().run();
    TestSpace().run();
    TestKnight().run();
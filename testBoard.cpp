@@ -19,6 +19,7 @@
 #include "pieceRook.h"
 #include "pieceBishop.h"
 #include "board.h"
+#include "attacks.h"
 #include <cassert>
 
 
@@ -499,6 +500,7 @@ void TestBoard::set_a8()
 ***********************************************/
 void TestBoard::createDummyBoard(Board& board)
 {
+  board.free();
   for (int r = 0; r < 8; r++)
      for (int c = 0; c < 8; c++)
      {
@@ -850,6 +852,38 @@ void TestBoard::move_pawnPromotion()
    board.board[0][6] = board.board[0][7] = nullptr;
 }
 
+/********************************************************
+ *    a7a8N
+ * +---a-b-c-d-e-f-g-h---+       +---a-b-c-d-e-f-g-h---+
+ * |                     |       |                     |
+ * 8   .     k           8       8  (n)    k           8
+ * 7  (p)                7       7   .                 7
+ * 6                     6       6                     6
+ * 5                     5       5                     5
+ * 4                     4  -->  4                     4
+ * 3                     3       3                     3
+ * 2                     2       2                     2
+ * 1         K           1       1         K           1
+ * |                     |       |                     |
+ * +---a-b-c-d-e-f-g-h---+       +---a-b-c-d-e-f-g-h---+
+ ********************************************************/
+void TestBoard::move_pawnUnderpromotion()
+{  // SETUP
+   Board board;
+   board.loadFEN("4k3/P7/8/8/8/8/8/4K3 w - - 0 1");
+   Move move = PackedMove("a7a8N").getMove();
+
+   // EXERCISE
+   board.move(move);
+
+   // VERIFY
+   assertUnit(KNIGHT == (board.board[0][7])->getType());
+   assertUnit((board.board[0][7])->isWhite());
+   assertUnit(KNIGHT == board.getPieceType(Position("a8").getLocation()));
+   assertUnit(SPACE  == board.getPieceType(Position("a7").getLocation()));
+   assertUnit(board.getKey() == board.computeKey());
+}  // TEARDOWN
+
 
 /********************************************************
  *    e5a5
@@ -1276,7 +1310,9 @@ void TestBoard::move_kingShortCastle()
    Board board(nullptr, true /*noreset*/);
    board.numMoves = 0;
    board.board[4][0] = new King(4, 0, true  /*isWhite*/);
-   board.board[6][0] = new Rook(6, 0, true  /*isWhite*/);
+   board.board[6][0] = new Space(6, 0);
+   board.board[5][0] = new Space(5, 0);
+   board.board[7][0] = new Rook(7, 0, true  /*isWhite*/);
    board.board[4][0]->nMoves = 0;
    PieceSpy::reset();
 
@@ -1284,16 +1320,22 @@ void TestBoard::move_kingShortCastle()
    board.move(move);
 
    // VERIFY
-   assertUnit(0 == board.numMoves);
-   assertUnit(ROOK == (board.board[4][0])->getType());
+   assertUnit(1 == board.numMoves);
+   assertUnit(1 == board.numUndo);
+   assertUnit(SPACE == (board.board[4][0])->getType());
    assertUnit(KING == (board.board[6][0])->getType());
+   assertUnit(ROOK == (board.board[5][0])->getType());
+   assertUnit(SPACE == (board.board[7][0])->getType());
+   assertUnit(Position(5, 0) == (board.board[5][0])->getPosition());
    assertUnit(SPACE == move.getCapturedPieceType());
    assertUnit(Move::CASTLE_KING == move.getMoveType());
 
    // TEARDOWN
    delete board.board[4][0];
    delete board.board[6][0];
-   board.board[4][0] = board.board[6][0] = nullptr;
+   delete board.board[5][0];
+   delete board.board[7][0];
+   board.board[4][0] = board.board[6][0] = board.board[5][0] = board.board[7][0] = nullptr;
 }
 
 
@@ -1325,7 +1367,9 @@ void TestBoard::move_kingLongCastle()
    Board board(nullptr, true /*noreset*/);
    board.numMoves = 0;
    board.board[4][0] = new King(4, 0, true  /*isWhite*/);
-   board.board[2][0] = new Rook(2, 0, true  /*isWhite*/);
+   board.board[2][0] = new Space(2, 0);
+   board.board[3][0] = new Space(3, 0);
+   board.board[0][0] = new Rook(0, 0, true  /*isWhite*/);
    board.board[4][0]->nMoves = 0;
    PieceSpy::reset();
 
@@ -1333,18 +1377,82 @@ void TestBoard::move_kingLongCastle()
    board.move(move);
 
    // VERIFY
-   assertUnit(0 == board.numMoves);
-   assertUnit(ROOK == (board.board[4][0])->getType());
+   assertUnit(1 == board.numMoves);
+   assertUnit(1 == board.numUndo);
+   assertUnit(SPACE == (board.board[4][0])->getType());
    assertUnit(KING == (board.board[2][0])->getType());
+   assertUnit(ROOK == (board.board[3][0])->getType());
+   assertUnit(SPACE == (board.board[0][0])->getType());
+   assertUnit(Position(3, 0) == (board.board[3][0])->getPosition());
    assertUnit(SPACE == move.getCapturedPieceType());
    assertUnit(Move::CASTLE_QUEEN == move.getMoveType());
 
    // TEARDOWN
    delete board.board[4][0];
    delete board.board[2][0];
-   board.board[4][0] = board.board[2][0] = nullptr;
+   delete board.board[3][0];
+   delete board.board[0][0];
+   board.board[4][0] = board.board[2][0] = board.board[3][0] = board.board[0][0] = nullptr;
 }
 
+/********************************************************
+ * MOVE : a castle is one move. It pushes one record and
+ *        counts once on the halfmove clock, and undo()
+ *        puts the king and rook back together
+ *    e1g1c
+ ********************************************************/
+void TestBoard::move_castleClock()
+{  // SETUP
+   Board board;
+   board.loadFEN("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 5 10");
+   uint64_t keyStart = board.getKey();
+   Move move = PackedMove("e1g1c").getMove();
+
+   // EXERCISE
+   board.move(move);
+
+   // VERIFY
+   assertUnit(board.toFEN() == "r3k2r/8/8/8/8/8/8/R4RK1 b kq - 6 10");
+   assertUnit(board.getUndoDepth() == 1);
+   assertUnit(board.getKey() == board.computeKey());
+
+   // EXERCISE
+   board.undo(move);
+
+   // VERIFY
+   assertUnit(board.toFEN() == "r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 5 10");
+   assertUnit(board.getUndoDepth() == 0);
+   assertUnit(board.getKey() == keyStart);
+}  // TEARDOWN
+
+/********************************************************
+ * MOVE : en passant records the pawn it took, and undo()
+ *        puts that pawn back beside the capturing one
+ *    d5e6E
+ ********************************************************/
+void TestBoard::move_enPassantRecord()
+{  // SETUP
+   Board board;
+   board.loadFEN("4k3/8/8/3Pp3/8/8/8/4K3 w - e6 0 1");
+   uint64_t keyStart = board.getKey();
+   Move move = PackedMove("d5e6E").getMove(PAWN);
+
+   // EXERCISE
+   board.move(move);
+
+   // VERIFY
+   assertUnit(board.toFEN() == "4k3/8/4P3/8/8/8/8/4K3 b - - 0 1");
+   assertUnit(board.getUndoDepth() == 1);
+   assertUnit(board.undoStack[0].capture == PAWN);
+
+   // EXERCISE
+   board.undo(move);
+
+   // VERIFY
+   assertUnit(board.toFEN() == "4k3/8/8/3Pp3/8/8/8/4K3 w - e6 0 1");
+   assertUnit(board.getKey() == keyStart);
+}  // TEARDOWN
+
 
 
 
@@ -1373,3 +1481,921 @@ void TestBoard::construct_default()
    assertUnit(board.numMoves == 0);
    
 } // TEARDOWN
+
+
+/********************************************************
+ * BITBOARDS : the starting position
+ *        +---a-b-c-d-e-f-g-h---+
+ *        |                     |
+ *        8   R N B Q K B N R   8
+ *        7   P P P P P P P P   7
+ *        6                     6
+ *        5                     5
+ *        4                     4
+ *        3                     3
+ *        2   p p p p p p p p   2
+ *        1   r n b q k b n r   1
+ *        |                     |
+ *        +---a-b-c-d-e-f-g-h---+
+ ********************************************************/
+void TestBoard::bitboards_reset()
+{
+   // SETUP
+   // EXERCISE
+   Board board;
+
+   // VERIFY
+   assertUnit(board.getPieces(PAWN,   true ) == 0x000000000000ff00ULL);
+   assertUnit(board.getPieces(PAWN,   false) == 0x00ff000000000000ULL);
+   assertUnit(board.getPieces(ROOK,   true ) == 0x0000000000000081ULL);
+   assertUnit(board.getPieces(KNIGHT, true ) == 0x0000000000000042ULL);
+   assertUnit(board.getPieces(BISHOP, true ) == 0x0000000000000024ULL);
+   assertUnit(board.getPieces(QUEEN,  true ) == 0x0000000000000008ULL);
+   assertUnit(board.getPieces(KING,   true ) == 0x0000000000000010ULL);
+   assertUnit(board.getPieces(KING,   false) == 0x1000000000000000ULL);
+   assertUnit(board.getColor(true)  == 0x000000000000ffffULL);
+   assertUnit(board.getColor(false) == 0xffff000000000000ULL);
+   assertUnit(board.getOccupied()   == 0xffff00000000ffffULL);
+   assertUnit(popCount(board.getOccupied()) == 32);
+   assertUnit(board.getPieceType(Position("e1").getLocation()) == KING);
+   assertUnit(board.getPieceType(Position("d8").getLocation()) == QUEEN);
+   assertUnit(board.getPieceType(Position("e4").getLocation()) == SPACE);
+}  // TEARDOWN
+
+/********************************************************
+ * PIECE CODE : the code on each square follows make
+ *              and unmake, promotions included
+ * +---a-b-c-d-e-f-g-h---+
+ * |                     |
+ * 8           r         8
+ * 7         p           7
+ * 6                     6
+ * 5                     5
+ * 4                     4
+ * 3                     3
+ * 2                     2
+ * 1                     1
+ * |                     |
+ * +---a-b-c-d-e-f-g-h---+
+ ********************************************************/
+void TestBoard::pieceCode_makeUnmake()
+{  // SETUP
+   Board board(nullptr, true /*noreset*/);
+   board.addPiece(0, PAWN, Position("e7").getLocation());
+   board.addPiece(1, ROOK, Position("f8").getLocation());
+   int e7 = Position("e7").getLocation();
+   int f8 = Position("f8").getLocation();
+
+   // EXERCISE
+   board.makeMove(PackedMove(Position("e7"), Position("f8"),
+                             PackedMove::promoteFlag(QUEEN, true /*isCapture*/)));
+
+   // VERIFY
+   assertUnit(board.getPieceCode(e7) == NO_PIECE);
+   assertUnit(board.getPieceCode(f8) == pieceCode(QUEEN, true /*isWhite*/));
+   board.unmakeMove();
+   assertUnit(board.getPieceCode(e7) == pieceCode(PAWN, true  /*isWhite*/));
+   assertUnit(board.getPieceCode(f8) == pieceCode(ROOK, false /*isWhite*/));
+   assertUnit(typeOf(board.getPieceCode(f8)) == ROOK);
+   assertUnit(!isWhiteCode(board.getPieceCode(f8)));
+}  // TEARDOWN
+
+/********************************************************
+ * RESET : the pieces already on the board are freed,
+ *         not left behind
+ ********************************************************/
+void TestBoard::reset_freesPieces()
+{  // SETUP
+   Board board(nullptr, true /*noreset*/);
+   board.board[4][4] = new PieceSpy(4, 4, true /*isWhite*/, KNIGHT);
+   PieceSpy::reset();
+
+   // EXERCISE
+   board.reset();
+
+   // VERIFY
+   assertUnit(PieceSpy::numDelete == 1);
+   assertUnit(SPACE == board.board[4][4]->getType());
+   assertUnit(KING  == board.board[4][0]->getType());
+}  // TEARDOWN
+
+/********************************************************
+ * BITBOARDS : a capture updates both colors
+ *    e5c6r
+ * +---a-b-c-d-e-f-g-h---+       +---a-b-c-d-e-f-g-h---+
+ * |                     |       |                     |
+ * 8                     8       8                     8
+ * 7                     7       7                     7
+ * 6       R             6       6       n             6
+ * 5          (n)        5       5           .         5
+ * 4                     4  -->  4                     4
+ * 3                     3       3                     3
+ * 2                     2       2                     2
+ * 1                     1       1                     1
+ * |                     |       |                     |
+ * +---a-b-c-d-e-f-g-h---+       +---a-b-c-d-e-f-g-h---+
+ ********************************************************/
+void TestBoard::bitboards_moveCapture()
+{  // SETUP
+   Move move;
+   move.source.set(4, 4);
+   move.dest.set(2, 5);
+   move.capture = ROOK;
+   move.promote = SPACE;
+   move.isWhite = true;
+   move.moveType = Move::MOVE;
+   Board board(nullptr, true /*noreset*/);
+   board.numMoves = 0;
+   board.board[4][4] = new Knight(4, 4, true  /*isWhite*/);
+   board.board[2][5] = new Rook(2, 5, false /*isWhite*/);
+   board.syncSquare(Position(4, 4));
+   board.syncSquare(Position(2, 5));
+
+   // EXERCISE
+   board.move(move);
+
+   // VERIFY
+   assertUnit(board.getPieces(KNIGHT, true) == squareBit(Position("c6").getLocation()));
+   assertUnit(board.getPieces(ROOK, false)  == 0);
+   assertUnit(board.getColor(false)         == 0);
+   assertUnit(board.getOccupied()           == squareBit(Position("c6").getLocation()));
+   assertUnit(board.getPieceType(Position("e5").getLocation()) == SPACE);
+
+   // TEARDOWN
+   delete board.board[4][4];
+   delete board.board[2][5];
+   board.board[4][4] = board.board[2][5] = nullptr;
+}
+
+/********************************************************
+ * MAKE UNMAKE : a double pawn push sets the en-passant
+ *               square and unmake puts everything back
+ *    e2e4
+ ********************************************************/
+void TestBoard::makeUnmake_pawnDouble()
+{  // SETUP
+   Board board;
+
+   // EXERCISE
+   board.makeMove(PackedMove(Position("e2"), Position("e4")));
+
+   // VERIFY
+   assertUnit(board.getPieces(PAWN, true) == 0x000000001000ef00ULL);
+   assertUnit(board.getColor(true)        == 0x000000001000efffULL);
+   assertUnit(board.getEnPassant()        == Position("e3").getLocation());
+   assertUnit(board.getHalfmoveClock()    == 0);
+   assertUnit(board.getCastling()         == CASTLE_ALL);
+   assertUnit(board.getCurrentMove()      == 1);
+   assertUnit(board.getUndoDepth()        == 1);
+
+   // EXERCISE
+   board.unmakeMove();
+
+   // VERIFY
+   assertUnit(board.getPieces(PAWN, true) == 0x000000000000ff00ULL);
+   assertUnit(board.getColor(true)        == 0x000000000000ffffULL);
+   assertUnit(board.getEnPassant()        == -1);
+   assertUnit(board.getCurrentMove()      == 0);
+   assertUnit(board.getUndoDepth()        == 0);
+}  // TEARDOWN
+
+/********************************************************
+ * MAKE UNMAKE : a capture removes the victim and
+ *               unmake brings it back
+ *    e5c6r
+ * +---a-b-c-d-e-f-g-h---+
+ * |                     |
+ * 8                     8
+ * 7                     7
+ * 6       r             6
+ * 5         (n)         5
+ * 4                     4
+ * 3                     3
+ * 2                     2
+ * 1                     1
+ * |                     |
+ * +---a-b-c-d-e-f-g-h---+
+ ********************************************************/
+void TestBoard::makeUnmake_capture()
+{  // SETUP
+   Board board(nullptr, true /*noreset*/);
+   board.addPiece(0, KNIGHT, Position("e5").getLocation());
+   board.addPiece(1, ROOK,   Position("c6").getLocation());
+   board.halfmoveClock = 5;
+
+   // EXERCISE
+   board.makeMove(PackedMove(Position("e5"), Position("c6"), PackedMove::CAPTURE));
+
+   // VERIFY
+   assertUnit(board.getPieces(KNIGHT, true) == squareBit(Position("c6").getLocation()));
+   assertUnit(board.getPieces(ROOK, false)  == 0);
+   assertUnit(board.getColor(false)         == 0);
+   assertUnit(board.getHalfmoveClock()      == 0);
+
+   // EXERCISE
+   board.unmakeMove();
+
+   // VERIFY
+   assertUnit(board.getPieces(KNIGHT, true) == squareBit(Position("e5").getLocation()));
+   assertUnit(board.getPieces(ROOK, false)  == squareBit(Position("c6").getLocation()));
+   assertUnit(board.getColor(false)         == squareBit(Position("c6").getLocation()));
+   assertUnit(board.getHalfmoveClock()      == 5);
+}  // TEARDOWN
+
+/********************************************************
+ * MAKE UNMAKE : castling moves the rook too and gives up
+ *               the white castling rights
+ *    e1g1c
+ * +---a-b-c-d-e-f-g-h---+
+ * |                     |
+ * 1         k     r     1
+ * |                     |
+ * +---a-b-c-d-e-f-g-h---+
+ ********************************************************/
+void TestBoard::makeUnmake_castle()
+{  // SETUP
+   Board board(nullptr, true /*noreset*/);
+   board.addPiece(0, KING, Position("e1").getLocation());
+   board.addPiece(0, ROOK, Position("h1").getLocation());
+   board.castling = CASTLE_ALL;
+
+   // EXERCISE
+   board.makeMove(PackedMove(Position("e1"), Position("g1"), PackedMove::CASTLE_KING));
+
+   // VERIFY
+   assertUnit(board.getPieces(KING, true) == squareBit(Position("g1").getLocation()));
+   assertUnit(board.getPieces(ROOK, true) == squareBit(Position("f1").getLocation()));
+   assertUnit(board.getCastling()         == (CASTLE_BLACK_KING | CASTLE_BLACK_QUEEN));
+
+   // EXERCISE
+   board.unmakeMove();
+
+   // VERIFY
+   assertUnit(board.getPieces(KING, true) == squareBit(Position("e1").getLocation()));
+   assertUnit(board.getPieces(ROOK, true) == squareBit(Position("h1").getLocation()));
+   assertUnit(board.getCastling()         == CASTLE_ALL);
+}  // TEARDOWN
+
+/********************************************************
+ * MAKE UNMAKE : a promotion that captures a rook in the
+ *               corner takes away black's castling right
+ *    b7a8rQ
+ * +---a-b-c-d-e-f-g-h---+
+ * |                     |
+ * 8   r                 8
+ * 7    (p)              7
+ * |                     |
+ * +---a-b-c-d-e-f-g-h---+
+ ********************************************************/
+void TestBoard::makeUnmake_promotion()
+{  // SETUP
+   Board board(nullptr, true /*noreset*/);
+   board.addPiece(0, PAWN, Position("b7").getLocation());
+   board.addPiece(1, ROOK, Position("a8").getLocation());
+   board.castling = CASTLE_ALL;
+
+   // EXERCISE
+   board.makeMove(PackedMove(Position("b7"), Position("a8"),
+                             PackedMove::promoteFlag(QUEEN, true /*isCapture*/)));
+
+   // VERIFY
+   assertUnit(board.getPieces(PAWN,  true)  == 0);
+   assertUnit(board.getPieces(QUEEN, true)  == squareBit(Position("a8").getLocation()));
+   assertUnit(board.getPieces(ROOK,  false) == 0);
+   assertUnit(board.getCastling()           == (CASTLE_ALL & ~CASTLE_BLACK_QUEEN));
+
+   // EXERCISE
+   board.unmakeMove();
+
+   // VERIFY
+   assertUnit(board.getPieces(PAWN,  true)  == squareBit(Position("b7").getLocation()));
+   assertUnit(board.getPieces(QUEEN, true)  == 0);
+   assertUnit(board.getPieces(ROOK,  false) == squareBit(Position("a8").getLocation()));
+   assertUnit(board.getCastling()           == CASTLE_ALL);
+}  // TEARDOWN
+
+/********************************************************
+ * MAKE UNMAKE : en passant removes the pawn beside the
+ *               destination, not the one on it
+ *    e5d6E
+ * +---a-b-c-d-e-f-g-h---+
+ * |                     |
+ * 6        (.)          6
+ * 5         P  p        5
+ * |                     |
+ * +---a-b-c-d-e-f-g-h---+
+ ********************************************************/
+void TestBoard::makeUnmake_enPassant()
+{  // SETUP
+   Board board(nullptr, true /*noreset*/);
+   board.addPiece(0, PAWN, Position("e5").getLocation());
+   board.addPiece(1, PAWN, Position("d5").getLocation());
+   board.enPassant = Position("d6").getLocation();
+
+   // EXERCISE
+   board.makeMove(PackedMove(Position("e5"), Position("d6"), PackedMove::ENPASSANT));
+
+   // VERIFY
+   assertUnit(board.getPieces(PAWN, true)  == squareBit(Position("d6").getLocation()));
+   assertUnit(board.getPieces(PAWN, false) == 0);
+   assertUnit(board.getEnPassant()         == -1);
+
+   // EXERCISE
+   board.unmakeMove();
+
+   // VERIFY
+   assertUnit(board.getPieces(PAWN, true)  == squareBit(Position("e5").getLocation()));
+   assertUnit(board.getPieces(PAWN, false) == squareBit(Position("d5").getLocation()));
+   assertUnit(board.getEnPassant()         == Position("d6").getLocation());
+}  // TEARDOWN
+
+/********************************************************
+ * SNAPSHOT : copying a snapshot back undoes a capture,
+ *            codes, state and key included
+ *    e4d5p
+ * +---a-b-c-d-e-f-g-h---+
+ * |                     |
+ * 5         p           5
+ * 4           P         4
+ * |                     |
+ * +---a-b-c-d-e-f-g-h---+
+ ********************************************************/
+void TestBoard::snapshot_restore()
+{  // SETUP
+   Board board(nullptr, true /*noreset*/);
+   board.addPiece(0, PAWN, Position("e4").getLocation());
+   board.addPiece(1, PAWN, Position("d5").getLocation());
+   board.castling = CASTLE_BLACK_KING;
+   board.halfmoveClock = 7;
+   board.key = board.computeKey();
+   BoardSnapshot saved = board.getSnapshot();
+   uint64_t key = board.getKey();
+
+   // EXERCISE
+   board.makeMove(PackedMove(Position("e4"), Position("d5"), PackedMove::CAPTURE));
+   board.setSnapshot(saved);
+
+   // VERIFY
+   assertUnit(board.getPieces(PAWN, true)  == squareBit(Position("e4").getLocation()));
+   assertUnit(board.getPieces(PAWN, false) == squareBit(Position("d5").getLocation()));
+   assertUnit(board.getPieceCode(Position("e4").getLocation()) == pieceCode(PAWN, true  /*isWhite*/));
+   assertUnit(board.getPieceCode(Position("d5").getLocation()) == pieceCode(PAWN, false /*isWhite*/));
+   assertUnit(board.getCastling()      == CASTLE_BLACK_KING);
+   assertUnit(board.getHalfmoveClock() == 7);
+   assertUnit(board.getCurrentMove()   == 0);
+   assertUnit(board.getKey()           == key);
+   assertUnit(board.getUndoDepth()     == 0);
+}  // TEARDOWN
+
+/********************************************************
+ * SNAPSHOT : a board built from a snapshot has the
+ *            same position and real pieces to draw
+ ********************************************************/
+void TestBoard::snapshot_construct()
+{  // SETUP
+   Board original;
+   original.makeMove(PackedMove(Position("g1"), Position("f3")));
+
+   // EXERCISE
+   Board copy(original.getSnapshot());
+
+   // VERIFY
+   assertUnit(copy.getOccupied()    == original.getOccupied());
+   assertUnit(copy.getKey()         == original.getKey());
+   assertUnit(copy.getCurrentMove() == 1);
+   assertUnit(copy.getPieceType(Position("f3").getLocation()) == KNIGHT);
+   assertUnit(copy.board[5][2]->getType() == KNIGHT);
+   assertUnit(copy.board[5][2]->isWhite());
+   assertUnit(copy.board[6][0]->getType() == SPACE);
+   assertUnit(copy.board[4][7]->getType() == KING);
+   assertUnit(!copy.board[4][7]->isWhite());
+}  // TEARDOWN
+
+/********************************************************
+ * LOAD FEN : the starting position, read from its FEN,
+ *            is the position reset() sets up
+ ********************************************************/
+void TestBoard::loadFEN_start()
+{  // SETUP
+   Board reset;
+   Board board(nullptr, true /*noreset*/);
+
+   // EXERCISE
+   bool isLoaded = board.loadFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+
+   // VERIFY
+   assertUnit(isLoaded);
+   for (int location = 0; location < 64; location++)
+      assertUnit(board.getPieceCode(location) == reset.getPieceCode(location));
+   assertUnit(board.getOccupied()      == reset.getOccupied());
+   assertUnit(board.getCastling()      == CASTLE_ALL);
+   assertUnit(board.getEnPassant()     == -1);
+   assertUnit(board.getCurrentMove()   == 0);
+   assertUnit(board.getKey()           == reset.getKey());
+   assertUnit(board.board[3][7]->getType() == QUEEN);
+   assertUnit(!board.board[3][7]->isWhite());
+   assertUnit(board.board[3][3]->getType() == SPACE);
+}  // TEARDOWN
+
+/********************************************************
+ * LOAD FEN : every field is read
+ *    r3k3/8/8/2Pp4/8/8/8/R3K3 w Qq d6 3 40
+ ********************************************************/
+void TestBoard::loadFEN_fields()
+{  // SETUP
+   Board board;
+
+   // EXERCISE
+   bool isLoaded = board.loadFEN("r3k3/8/8/2Pp4/8/8/8/R3K3 w Qq d6 3 40");
+
+   // VERIFY
+   assertUnit(isLoaded);
+   assertUnit(board.getPieces(KING, true)  == squareBit(Position("e1").getLocation()));
+   assertUnit(board.getPieces(KING, false) == squareBit(Position("e8").getLocation()));
+   assertUnit(board.getPieces(ROOK, true)  == squareBit(Position("a1").getLocation()));
+   assertUnit(board.getPieces(ROOK, false) == squareBit(Position("a8").getLocation()));
+   assertUnit(board.getPieces(PAWN, true)  == squareBit(Position("c5").getLocation()));
+   assertUnit(board.getPieces(PAWN, false) == squareBit(Position("d5").getLocation()));
+   assertUnit(board.getCastling()      == (CASTLE_WHITE_QUEEN | CASTLE_BLACK_QUEEN));
+   assertUnit(board.getEnPassant()     == Position("d6").getLocation());
+   assertUnit(board.getHalfmoveClock() == 3);
+   assertUnit(board.getCurrentMove()   == 78);
+   assertUnit(board.getKey()           == board.computeKey());
+   assertUnit(board.board[0][0]->getType() == ROOK);
+   assertUnit(board.board[0][1]->getType() == SPACE);
+   assertUnit(board.toFEN() == "r3k3/8/8/2Pp4/8/8/8/R3K3 w Qq d6 3 40");
+}  // TEARDOWN
+
+/********************************************************
+ * LOAD FEN : EPD leaves the clocks off; they start over
+ ********************************************************/
+void TestBoard::loadFEN_noClocks()
+{  // SETUP
+   Board board;
+
+   // EXERCISE
+   bool isLoaded = board.loadFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq -");
+
+   // VERIFY
+   assertUnit(isLoaded);
+   assertUnit(board.getHalfmoveClock() == 0);
+   assertUnit(board.getCurrentMove()   == 1);
+   assertUnit(board.toFEN() == "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 0 1");
+}  // TEARDOWN
+
+/********************************************************
+ * LOAD FEN : nonsense is turned away and the board
+ *            is left as it was
+ ********************************************************/
+void TestBoard::loadFEN_rejects()
+{  // SETUP
+   Board board;
+   uint64_t key = board.getKey();
+   const char * bad[] =
+   {
+      "",
+      "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP w KQkq - 0 1",          // seven ranks
+      "rnbqkbnr/pppppppp/9/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", // nine files
+      "rnbqkbnr/ppppxppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", // no such piece
+      "rnbq1bnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", // no black king
+      "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNP w KQkq - 0 1", // pawn on rank 1
+      "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR x KQkq - 0 1", // whose turn?
+      "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQxq - 0 1", // castling
+      "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq e3 0 1",// wrong rank
+      "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - x 1", // clock
+      "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 99999 1", // clock past 16 bits
+      "rnbqkbn1/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", // k, no h8 rook
+      "rnbqkbnr/pppppppp/8/8/8/8/PPPPKPPP/RNBQ1BNR w KQkq - 0 1", // KQ, king on e2
+      "4k3/8/8/8/8/8/4R3/4K3 w - - 0 1",                          // black left in check
+      "4k3/8/8/3P4/8/8/8/4K3 w - e6 0 1",                         // no pawn on e5
+      "4k3/8/4p3/3P4/8/8/8/4K3 w - e6 0 1",                       // e6 is taken
+      "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1 extra",
+      "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq"
+   };
+
+   // EXERCISE
+   // VERIFY
+   for (const char * fen : bad)
+      assertUnit(!board.loadFEN(fen));
+   assertUnit(board.getKey() == key);
+   assertUnit(board.toFEN() == "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+}  // TEARDOWN
+
+/********************************************************
+ * TO FEN : a double pawn move leaves an en-passant
+ *          square and passes the turn
+ ********************************************************/
+void TestBoard::toFEN_afterMove()
+{  // SETUP
+   Board board;
+
+   // EXERCISE
+   board.makeMove(PackedMove(Position("e2"), Position("e4")));
+
+   // VERIFY
+   assertUnit(board.toFEN() == "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1");
+}  // TEARDOWN
+
+/********************************************************
+ * KEY : the starting position has a key, and it is the
+ *       same every time
+ ********************************************************/
+void TestBoard::key_reset()
+{  // SETUP
+   // EXERCISE
+   Board board1;
+   Board board2;
+
+   // VERIFY
+   assertUnit(board1.getKey() != 0);
+   assertUnit(board1.getKey() == board1.computeKey());
+   assertUnit(board1.getKey() == board2.getKey());
+}  // TEARDOWN
+
+/********************************************************
+ * KEY : every make and unmake keeps the key in step with
+ *       the position, and unmake brings the old key back
+ *    e2e4 d7d5 e4d5p e8d7
+ ********************************************************/
+void TestBoard::key_makeUnmake()
+{  // SETUP
+   Board board;
+   uint64_t keyStart = board.getKey();
+
+   // EXERCISE
+   board.makeMove(PackedMove(Position("e2"), Position("e4")));
+   uint64_t keyE4 = board.getKey();
+   assertUnit(keyE4 == board.computeKey());
+   board.makeMove(PackedMove(Position("d7"), Position("d5")));
+   assertUnit(board.getKey() == board.computeKey());
+   board.makeMove(PackedMove(Position("e4"), Position("d5"), PackedMove::CAPTURE));
+   assertUnit(board.getKey() == board.computeKey());
+   board.makeMove(PackedMove(Position("e8"), Position("d7")));
+   assertUnit(board.getKey() == board.computeKey());
+   board.unmakeMove();
+   board.unmakeMove();
+   board.unmakeMove();
+
+   // VERIFY
+   assertUnit(board.getKey() == keyE4);
+   board.unmakeMove();
+   assertUnit(board.getKey() == keyStart);
+}  // TEARDOWN
+
+/********************************************************
+ * KEY : the same position reached by different moves
+ *       has the same key
+ *    g1f3 g8f6 f3g1 f6g8  returns to the start
+ ********************************************************/
+void TestBoard::key_transposition()
+{  // SETUP
+   Board board;
+   uint64_t keyStart = board.getKey();
+
+   // EXERCISE
+   board.makeMove(PackedMove(Position("g1"), Position("f3")));
+   board.makeMove(PackedMove(Position("g8"), Position("f6")));
+   board.makeMove(PackedMove(Position("f3"), Position("g1")));
+   uint64_t keyBlackToMove = board.getKey();
+   board.makeMove(PackedMove(Position("f6"), Position("g8")));
+
+   // VERIFY
+   assertUnit(board.getKey() == keyStart);
+   assertUnit(keyBlackToMove != keyStart);
+}  // TEARDOWN
+
+/********************************************************
+ * KEY : the legacy move() and undo() keep the key too
+ *    e2e4
+ ********************************************************/
+void TestBoard::key_moveUndo()
+{  // SETUP
+   Board board;
+   uint64_t keyStart = board.getKey();
+   Move e2e4("e2e4");
+
+   // EXERCISE
+   board.move(e2e4);
+
+   // VERIFY
+   assertUnit(board.getKey() != keyStart);
+   assertUnit(board.getKey() == board.computeKey());
+   assertUnit(board.getEnPassant() == Position("e3").getLocation());
+
+   // EXERCISE
+   board.undo(e2e4);
+
+   // VERIFY
+   assertUnit(board.getKey() == keyStart);
+}  // TEARDOWN
+
+/********************************************************
+ * IS SQUARE ATTACKED : knights, kings and pawns
+ * +---a-b-c-d-e-f-g-h---+
+ * |                     |
+ * 5           p         5
+ * 4                     4
+ * 3       N             3
+ * 2                     2
+ * 1 K                   1
+ * |                     |
+ * +---a-b-c-d-e-f-g-h---+
+ ********************************************************/
+void TestBoard::isSquareAttacked_leapers()
+{  // SETUP
+   Board board(nullptr, true /*noreset*/);
+   board.addPiece(0, KNIGHT, Position("c3").getLocation());
+   board.addPiece(0, KING,   Position("a1").getLocation());
+   board.addPiece(1, PAWN,   Position("e5").getLocation());
+
+   // EXERCISE
+   // VERIFY
+   assertUnit( board.isSquareAttacked(Position("d5").getLocation(), true));   // knight
+   assertUnit( board.isSquareAttacked(Position("e4").getLocation(), true));   // knight
+   assertUnit(!board.isSquareAttacked(Position("c4").getLocation(), true));
+   assertUnit( board.isSquareAttacked(Position("b2").getLocation(), true));   // king
+   assertUnit( board.isSquareAttacked(Position("d4").getLocation(), false));  // pawn
+   assertUnit( board.isSquareAttacked(Position("f4").getLocation(), false));  // pawn
+   assertUnit(!board.isSquareAttacked(Position("e4").getLocation(), false));  // pawn push
+   assertUnit(!board.isSquareAttacked(Position("d6").getLocation(), false));  // behind the pawn
+}  // TEARDOWN
+
+/********************************************************
+ * IS SQUARE ATTACKED : sliders stop at the first piece
+ * +---a-b-c-d-e-f-g-h---+
+ * |                     |
+ * 8 r                   8
+ * 7                     7
+ * 6                     6
+ * 5                     5
+ * 4 P                   4
+ * 3                     3
+ * 2             b       2
+ * 1                     1
+ * |                     |
+ * +---a-b-c-d-e-f-g-h---+
+ ********************************************************/
+void TestBoard::isSquareAttacked_sliders()
+{  // SETUP
+   Board board(nullptr, true /*noreset*/);
+   board.addPiece(1, ROOK,   Position("a8").getLocation());
+   board.addPiece(0, PAWN,   Position("a4").getLocation());
+   board.addPiece(1, BISHOP, Position("g2").getLocation());
+
+   // EXERCISE
+   // VERIFY
+   assertUnit( board.isSquareAttacked(Position("a5").getLocation(), false));
+   assertUnit( board.isSquareAttacked(Position("a4").getLocation(), false));  // the blocker itself
+   assertUnit(!board.isSquareAttacked(Position("a3").getLocation(), false));  // behind the blocker
+   assertUnit( board.isSquareAttacked(Position("h8").getLocation(), false));
+   assertUnit( board.isSquareAttacked(Position("b7").getLocation(), false));  // bishop, long diagonal
+   assertUnit( board.isSquareAttacked(Position("h1").getLocation(), false));
+   assertUnit(!board.isSquareAttacked(Position("g3").getLocation(), false));
+}  // TEARDOWN
+
+/********************************************************
+ * IS CHECKED : a rook gives check until a piece
+ *              steps in between
+ * +---a-b-c-d-e-f-g-h---+
+ * |                     |
+ * 8         r           8
+ * 7                     7
+ * 6                     6
+ * 5                     5
+ * 4                     4
+ * 3                     3
+ * 2                     2
+ * 1         K           1
+ * |                     |
+ * +---a-b-c-d-e-f-g-h---+
+ ********************************************************/
+void TestBoard::isChecked_blocked()
+{  // SETUP
+   Board board(nullptr, true /*noreset*/);
+   board.addPiece(0, KING, Position("e1").getLocation());
+   board.addPiece(1, ROOK, Position("e8").getLocation());
+   board.addPiece(1, KING, Position("a8").getLocation());
+
+   // EXERCISE
+   // VERIFY
+   assertUnit( board.isChecked(true  /*isWhite*/));
+   assertUnit(!board.isChecked(false /*isWhite*/));
+   board.addPiece(0, KNIGHT, Position("e4").getLocation());
+   assertUnit(!board.isChecked(true  /*isWhite*/));
+}  // TEARDOWN
+
+/********************************************************
+ * SLIDER ATTACKS : the magic lookups agree with walking
+ *                  each ray, from every square, for many
+ *                  scattered sets of blockers
+ ********************************************************/
+void TestBoard::sliderAttacks_matchRays()
+{  // SETUP
+   uint64_t seed = 0x2545f4914f6cdd1dULL;
+   bool isMatch = true;
+
+   // EXERCISE
+   for (int trial = 0; trial < 200; trial++)
+   {
+      seed ^= seed << 13;
+      seed ^= seed >> 7;
+      seed ^= seed << 17;
+      Bitboard occupied = seed & (seed >> 3);   // about one square in four
+      for (int location = 0; location < 64; location++)
+      {
+         Bitboard straight = rayAttacks(location, occupied, NORTH) | rayAttacks(location, occupied, SOUTH) |
+                             rayAttacks(location, occupied, EAST)  | rayAttacks(location, occupied, WEST);
+         Bitboard diagonal = rayAttacks(location, occupied, NORTH_EAST) | rayAttacks(location, occupied, NORTH_WEST) |
+                             rayAttacks(location, occupied, SOUTH_EAST) | rayAttacks(location, occupied, SOUTH_WEST);
+         if (rookAttacks(location, occupied) != straight || bishopAttacks(location, occupied) != diagonal)
+            isMatch = false;
+      }
+   }
+
+   // VERIFY
+   assertUnit(isMatch);
+}  // TEARDOWN
+
+/********************************************************
+ * SLIDER ATTACKS : both backends give the same attacks.
+ *                  Nothing to compare where the processor
+ *                  has no PEXT
+ ********************************************************/
+void TestBoard::sliderAttacks_pextMatchesMagic()
+{  // SETUP
+   if (!hasPext())
+      return;
+   SliderBackend original = SLIDER_BACKEND;
+   Bitboard occupied[] = { EMPTY_BB, 0xffff00000000ffffULL, 0x0042240000244200ULL,
+                           0x8100001818000081ULL, 0x00ff00ff00ff00ffULL };
+   Bitboard rook[5][64];
+   Bitboard bishop[5][64];
+   bool isMatch = true;
+
+   // EXERCISE
+   setSliderBackend(SLIDER_MAGIC);
+   for (int i = 0; i < 5; i++)
+      for (int location = 0; location < 64; location++)
+      {
+         rook[i][location]   = rookAttacks(location, occupied[i]);
+         bishop[i][location] = bishopAttacks(location, occupied[i]);
+      }
+   setSliderBackend(SLIDER_PEXT);
+   for (int i = 0; i < 5; i++)
+      for (int location = 0; location < 64; location++)
+         if (rookAttacks(location, occupied[i])   != rook[i][location] ||
+             bishopAttacks(location, occupied[i]) != bishop[i][location])
+            isMatch = false;
+
+   // VERIFY
+   assertUnit(isMatch);
+
+   // TEARDOWN
+   setSliderBackend(original);
+}
+
+/********************************************************
+ * SEE : taking an undefended pawn wins the pawn, and
+ *       a quiet move to a safe square wins nothing
+ * +---a-b-c-d-e-f-g-h---+
+ * |                     |
+ * 8           k         8
+ * 7                     7
+ * 6                     6
+ * 5         p           5
+ * 4                     4
+ * 3                     3
+ * 2                     2
+ * 1         R K         1
+ * |                     |
+ * +---a-b-c-d-e-f-g-h---+
+ ********************************************************/
+void TestBoard::see_undefended()
+{  // SETUP
+   Board board;
+   board.loadFEN("4k3/8/8/3p4/8/8/8/3RK3 w - - 0 1");
+   PackedMove capture(Position("d1"), Position("d5"), PackedMove::CAPTURE);
+   PackedMove quiet(Position("d1"), Position("a1"));
+
+   // EXERCISE
+   int seeCapture = board.see(capture);
+   int seeQuiet   = board.see(quiet);
+
+   // VERIFY
+   assertUnit(seeCapture == 100);
+   assertUnit(seeQuiet == 0);
+   assertUnit( board.seeGE(capture, 100));
+   assertUnit(!board.seeGE(capture, 101));
+   assertUnit( board.seeGE(quiet, 0));
+   assertUnit(!board.seeGE(quiet, 1));
+}  // TEARDOWN
+
+/********************************************************
+ * SEE : a knight that takes a defended pawn is lost
+ *       for it, and so is one that steps where a pawn
+ *       can take it
+ * +---a-b-c-d-e-f-g-h---+
+ * |                     |
+ * 8           k         8
+ * 7                     7
+ * 6       p             6
+ * 5         p           5
+ * 4                     4
+ * 3           N         3
+ * 2                     2
+ * 1           K         1
+ * |                     |
+ * +---a-b-c-d-e-f-g-h---+
+ ********************************************************/
+void TestBoard::see_defended()
+{  // SETUP
+   Board board;
+   board.loadFEN("4k3/8/2p5/3p4/8/4N3/8/4K3 w - - 0 1");
+   PackedMove capture(Position("e3"), Position("d5"), PackedMove::CAPTURE);
+   PackedMove attacked(Position("e3"), Position("c4"));
+   PackedMove safe(Position("e3"), Position("g4"));
+
+   // EXERCISE
+   int seeCapture  = board.see(capture);
+   int seeAttacked = board.see(attacked);
+   int seeSafe     = board.see(safe);
+
+   // VERIFY
+   assertUnit(seeCapture == 100 - 320);
+   assertUnit(seeAttacked == -320);
+   assertUnit(seeSafe == 0);
+   assertUnit( board.seeGE(capture, -220));
+   assertUnit(!board.seeGE(capture, -219));
+   assertUnit(!board.seeGE(capture, 0));
+}  // TEARDOWN
+
+/********************************************************
+ * SEE : the queen behind the rook takes back once the
+ *       rook has captured, so the pawn is won for nothing.
+ *       Without the queen the rook is lost for the pawn
+ * +---a-b-c-d-e-f-g-h---+
+ * |                     |
+ * 8         r k         8
+ * 7                     7
+ * 6                     6
+ * 5         p           5
+ * 4                     4
+ * 3                     3
+ * 2         R           2
+ * 1         Q K         1
+ * |                     |
+ * +---a-b-c-d-e-f-g-h---+
+ ********************************************************/
+void TestBoard::see_xray()
+{  // SETUP
+   Board board;
+   Board boardNoQueen;
+   board.loadFEN("3rk3/8/8/3p4/8/8/3R4/3QK3 w - - 0 1");
+   boardNoQueen.loadFEN("3rk3/8/8/3p4/8/8/3R4/4K3 w - - 0 1");
+   PackedMove capture(Position("d2"), Position("d5"), PackedMove::CAPTURE);
+
+   // EXERCISE
+   int seeQueen   = board.see(capture);
+   int seeNoQueen = boardNoQueen.see(capture);
+
+   // VERIFY
+   assertUnit(seeQueen == 100);
+   assertUnit(seeNoQueen == 100 - 500);
+   assertUnit( board.seeGE(capture, 0));
+   assertUnit(!boardNoQueen.seeGE(capture, 0));
+}  // TEARDOWN
+
+/********************************************************
+ * SEE : the king does not take back on a square the
+ *       second rook still guards, but takes the lone rook
+ * +---a-b-c-d-e-f-g-h---+
+ * |                     |
+ * 8                     8
+ * 7                     7
+ * 6           k         6
+ * 5         p           5
+ * 4                     4
+ * 3                     3
+ * 2         R           2
+ * 1         R K         1
+ * |                     |
+ * +---a-b-c-d-e-f-g-h---+
+ ********************************************************/
+void TestBoard::see_kingRecapture()
+{  // SETUP
+   Board board;
+   Board boardOneRook;
+   board.loadFEN("8/8/4k3/3p4/8/8/3R4/3RK3 w - - 0 1");
+   boardOneRook.loadFEN("8/8/4k3/3p4/8/8/3R4/4K3 w - - 0 1");
+   PackedMove capture(Position("d2"), Position("d5"), PackedMove::CAPTURE);
+
+   // EXERCISE
+   int seeTwo = board.see(capture);
+   int seeOne = boardOneRook.see(capture);
+
+   // VERIFY
+   assertUnit(seeTwo == 100);
+   assertUnit(seeOne == 100 - 500);
+   assertUnit( board.seeGE(capture, 100));
+   assertUnit(!boardOneRook.seeGE(capture, 0));
+}  // TEARDOWN
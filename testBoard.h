@@ -50,6 +50,7 @@ public:
       move_pawnDouble();
       move_pawnEnpassant();
       move_pawnPromotion();
+      move_pawnUnderpromotion();
       move_rookSlide();
       move_rookAttack();
       move_bishopSlide();
@@ -62,6 +63,51 @@ public:
       move_kingAttack();
       move_kingShortCastle();
       move_kingLongCastle();
+      move_castleClock();
+      move_enPassantRecord();
+
+      // bitboards
+      bitboards_reset();
+      bitboards_moveCapture();
+      pieceCode_makeUnmake();
+      reset_freesPieces();
+
+      // make and unmake
+      makeUnmake_pawnDouble();
+      makeUnmake_capture();
+      makeUnmake_castle();
+      makeUnmake_promotion();
+      makeUnmake_enPassant();
+
+      // copy-make
+      snapshot_restore();
+      snapshot_construct();
+
+      // FEN
+      loadFEN_start();
+      loadFEN_fields();
+      loadFEN_noClocks();
+      loadFEN_rejects();
+      toFEN_afterMove();
+
+      // zobrist key
+      key_reset();
+      key_makeUnmake();
+      key_transposition();
+      key_moveUndo();
+
+      // attacks
+      isSquareAttacked_leapers();
+      isSquareAttacked_sliders();
+      isChecked_blocked();
+      sliderAttacks_matchRays();
+      sliderAttacks_pextMatchesMagic();
+
+      // static exchange
+      see_undefended();
+      see_defended();
+      see_xray();
+      see_kingRecapture();
       report("Board");
    }
 private:
@@ -85,6 +131,7 @@ private:
    void move_pawnDouble();
    void move_pawnEnpassant();
    void move_pawnPromotion();
+   void move_pawnUnderpromotion();
    void move_rookSlide();
    void move_rookAttack();
    void move_bishopSlide();
@@ -97,7 +144,38 @@ private:
    void move_kingAttack();
    void move_kingShortCastle();
    void move_kingLongCastle();
+   void move_castleClock();
+   void move_enPassantRecord();
 
+   void bitboards_reset();
+   void pieceCode_makeUnmake();
+   void reset_freesPieces();
+   void bitboards_moveCapture();
+   void makeUnmake_pawnDouble();
+   void makeUnmake_capture();
+   void makeUnmake_castle();
+   void makeUnmake_promotion();
+   void makeUnmake_enPassant();
+   void snapshot_restore();
+   void snapshot_construct();
+   void loadFEN_start();
+   void loadFEN_fields();
+   void loadFEN_noClocks();
+   void loadFEN_rejects();
+   void toFEN_afterMove();
+   void key_reset();
+   void key_makeUnmake();
+   void key_transposition();
+   void key_moveUndo();
+   void isSquareAttacked_leapers();
+   void isSquareAttacked_sliders();
+   void isChecked_blocked();
+   void sliderAttacks_matchRays();
+   void sliderAttacks_pextMatchesMagic();
+   void see_undefended();
+   void see_defended();
+   void see_xray();
+   void see_kingRecapture();
 
    void fetch_a1();
    void fetch_h8();
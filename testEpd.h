@@ -0,0 +1,208 @@
+/***********************************************************************
+ * Header File:
+ *    TEST EPD
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    The unit tests for reading and running EPD suites
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "epd.h"
+#include "board.h"
+#include <sstream>
+
+ /***************************************************
+  * EPD TEST
+  * Test parseEpd() and the EpdSuite
+  ***************************************************/
+class TestEpd : public UnitTest
+{
+public:
+
+   void run()
+   {
+      parse_perft();
+      parse_operations();
+      parse_blank();
+      parseSan_pieces();
+      parseSan_pawns();
+      suite_read();
+      suite_run();
+
+      report("Epd");
+   }
+private:
+
+   /*************************************
+    * PARSE : a line of a perft suite
+    * Input:  the start position, D1 through D3
+    * Output: the FEN and the three counts
+    **************************************/
+   void parse_perft()
+   {
+      // SETUP
+      EpdPosition position;
+
+      // EXERCISE
+      bool isPosition = parseEpd("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - ;D1 20 ;D2 400 ;D3 8902",
+                                 position);
+
+      // VERIFY
+      assertUnit(isPosition);
+      assertUnit(position.fen == "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq -");
+      assertUnit(position.perft[1] == 20);
+      assertUnit(position.perft[2] == 400);
+      assertUnit(position.perft[3] == 8902);
+      assertUnit(position.perft[4] == 0);
+      assertUnit(position.id.empty());
+   }  // TEARDOWN
+
+   /*************************************
+    * PARSE : a line of a tactical suite
+    * Input:  bm with two moves, am, a quoted id
+    *         and an opcode we do not use
+    * Output: each of them, the unknown one ignored
+    **************************************/
+   void parse_operations()
+   {
+      // SETUP
+      EpdPosition position;
+
+      // EXERCISE
+      bool isPosition = parseEpd("4k3/8/8/8/8/8/8/R3K3 w Q - bm Ra8+ Kd2; am O-O-O; c0 \"a comment\"; id \"mate.1\";",
+                                 position);
+
+      // VERIFY
+      assertUnit(isPosition);
+      assertUnit(position.fen == "4k3/8/8/8/8/8/8/R3K3 w Q -");
+      assertUnit(position.bestMoves.size() == 2);
+      assertUnit(position.bestMoves[0] == "Ra8+");
+      assertUnit(position.bestMoves[1] == "Kd2");
+      assertUnit(position.avoidMoves.size() == 1);
+      assertUnit(position.avoidMoves[0] == "O-O-O");
+      assertUnit(position.id == "mate.1");
+   }  // TEARDOWN
+
+   /*************************************
+    * PARSE : blank lines and comments are not positions
+    **************************************/
+   void parse_blank()
+   {
+      // SETUP
+      EpdPosition position;
+
+      // EXERCISE
+      // VERIFY
+      assertUnit(!parseEpd("", position));
+      assertUnit(!parseEpd("   \r", position));
+      assertUnit(!parseEpd("# perft suite", position));
+   }  // TEARDOWN
+
+   /*************************************
+    * PARSE SAN : piece moves, castling, and a knight
+    *             that needs its file to say which
+    * +---a-b-c-d-e-f-g-h---+
+    * 1   R N     K     R   1   and a knight on f3
+    * +---a-b-c-d-e-f-g-h---+
+    **************************************/
+   void parseSan_pieces()
+   {
+      // SETUP
+      Board board;
+      board.loadFEN("4k3/8/8/8/8/5N2/8/RN2K2R w KQ - 0 1");
+
+      // EXERCISE
+      // VERIFY
+      assertUnit(parseSan(board, "Nfd2")  == PackedMove(Position("f3"), Position("d2")));
+      assertUnit(parseSan(board, "Nbd2")  == PackedMove(Position("b1"), Position("d2")));
+      assertUnit(parseSan(board, "Na3")   == PackedMove(Position("b1"), Position("a3")));
+      assertUnit(parseSan(board, "Nd2").isNull());        // either knight
+      assertUnit(parseSan(board, "O-O+")  == PackedMove(Position("e1"), Position("g1"), PackedMove::CASTLE_KING));
+      assertUnit(parseSan(board, "0-0-0").isNull());      // the knight is in the way
+      assertUnit(parseSan(board, "Ra8+")  == PackedMove(Position("a1"), Position("a8")));
+      assertUnit(parseSan(board, "Qd1").isNull());        // no queen
+   }  // TEARDOWN
+
+   /*************************************
+    * PARSE SAN : pushes, captures and promotions
+    **************************************/
+   void parseSan_pawns()
+   {
+      // SETUP
+      Board board;
+      board.loadFEN("1n2k3/P7/8/3pP3/8/8/4P3/4K3 w - d6 0 1");
+
+      // EXERCISE
+      // VERIFY
+      assertUnit(parseSan(board, "e4")    == PackedMove(Position("e2"), Position("e4")));
+      assertUnit(parseSan(board, "exd6")  == PackedMove(Position("e5"), Position("d6"), PackedMove::ENPASSANT));
+      assertUnit(parseSan(board, "a8=Q")  == PackedMove(Position("a7"), Position("a8"), PackedMove::promoteFlag(QUEEN, false)));
+      assertUnit(parseSan(board, "axb8N#") == PackedMove(Position("a7"), Position("b8"), PackedMove::promoteFlag(KNIGHT, true)));
+      assertUnit(parseSan(board, "a8").isNull());         // a promotion must say to what
+   }  // TEARDOWN
+
+   /*************************************
+    * READ : every position, with its line number
+    **************************************/
+   void suite_read()
+   {
+      // SETUP
+      EpdSuite suite;
+      std::istringstream in("# two positions\n"
+                            "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - ;D1 14\n"
+                            "\n"
+                            "4k3/8/8/8/8/8/8/R3K3 w Q - bm Ra8+;\n");
+
+      // EXERCISE
+      int numRead = suite.read(in);
+
+      // VERIFY
+      assertUnit(numRead == 2);
+      assertUnit(suite.getPositions().size() == 2);
+      assertUnit(suite.getPositions()[0].lineNumber == 2);
+      assertUnit(suite.getPositions()[1].lineNumber == 4);
+   }  // TEARDOWN
+
+   /*************************************
+    * RUN : each position gets its own result,
+    *       whichever thread checked it
+    * Input:  a good count, a wrong count, a bad FEN,
+    *         nothing to check, a mate the search finds,
+    *         and a bm that is no move, on three threads
+    * Output: pass, fail, fail, skip, pass, fail
+    **************************************/
+   void suite_run()
+   {
+      // SETUP
+      EpdSuite suite;
+      std::istringstream in(
+         "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ;D1 48 ;D2 2039\n"
+         "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - ;D1 14 ;D2 190\n"
+         "8/8/8 w - - ;D1 1\n"
+         "4k3/8/8/8/8/8/8/R3K3 w Q - id \"nothing\";\n"
+         "6k1/5ppp/8/8/8/8/8/R5K1 w - - bm Ra8#; am Kf2;\n"
+         "6k1/5ppp/8/8/8/8/8/R5K1 w - - bm Rh8#;\n");
+      suite.read(in);
+      suite.setSearchLimits(SearchLimits(2 /*depth*/));
+
+      // EXERCISE
+      suite.run(3);
+
+      // VERIFY
+      const std::vector<EpdResult> & results = suite.getResults();
+      assertUnit(results.size() == 6);
+      assertUnit(results[0].status == EpdResult::PASS);
+      assertUnit(results[0].nodes  == 48 + 2039);
+      assertUnit(results[1].status == EpdResult::FAIL);
+      assertUnit(results[1].failure == "D2 counted 191, expected 190");
+      assertUnit(results[2].status == EpdResult::FAIL);
+      assertUnit(results[3].status == EpdResult::SKIP);
+      assertUnit(results[4].status == EpdResult::PASS);
+      assertUnit(results[4].bestMove == PackedMove(Position("a1"), Position("a8")));
+      assertUnit(results[5].status == EpdResult::FAIL);
+      assertUnit(results[5].failure == "bm Rh8# is not a legal move");
+   }  // TEARDOWN
+};
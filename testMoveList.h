@@ -0,0 +1,162 @@
+/***********************************************************************
+ * Header File:
+ *    TEST MOVE LIST
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    The unit tests for the MoveList
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "moveList.h"
+#include "pieceKnight.h"
+#include "board.h"
+#include <set>
+
+ /***************************************************
+  * MOVE LIST TEST
+  * Test the MoveList class
+  ***************************************************/
+class TestMoveList : public UnitTest
+{
+public:
+
+   void run()
+   {
+      construct_empty();
+      add_three();
+      contains_fromTo();
+      sort_likeSet();
+      getMoves_knight();
+
+      report("MoveList");
+   }
+private:
+
+   /*************************************
+    * CONSTRUCT : empty
+    * Input:
+    * Output: size=0
+    **************************************/
+   void construct_empty()
+   {
+      // SETUP
+      // EXERCISE
+      MoveList moves;
+
+      // VERIFY
+      assertUnit(moves.num == 0);
+      assertUnit(moves.empty());
+      assertUnit(moves.begin() == moves.end());
+   }  // TEARDOWN
+
+   /*************************************
+    * ADD : three moves
+    * Input:  e2e4, g1f3, b8c6
+    * Output: the same three in order
+    **************************************/
+   void add_three()
+   {
+      // SETUP
+      MoveList moves;
+
+      // EXERCISE
+      moves.add(PackedMove("e2e4"));
+      moves.add(PackedMove("g1f3"));
+      moves.add(PackedMove("b8c6"));
+
+      // VERIFY
+      assertUnit(moves.size() == 3);
+      assertUnit(moves[0].getFrom() == Position("e2").getLocation());
+      assertUnit(moves[1].getFrom() == Position("g1").getLocation());
+      assertUnit(moves[2].getTo()   == Position("c6").getLocation());
+   }  // TEARDOWN
+
+   /*************************************
+    * CONTAINS : only source and destination matter
+    * Input:  e5c6r in the list
+    * Output: e5c6 is found, e5c7 is not
+    **************************************/
+   void contains_fromTo()
+   {
+      // SETUP
+      MoveList moves;
+      moves.add(PackedMove("e5c6r"));
+
+      // EXERCISE
+      bool found    = moves.contains(PackedMove("e5c6"));
+      bool notFound = moves.contains(PackedMove("e5c7"));
+
+      // VERIFY
+      assertUnit(found    == true);
+      assertUnit(notFound == false);
+   }  // TEARDOWN
+
+   /*************************************
+    * SORT : same order as std::set
+    * Input:  h2h3, a2a3, b1c3
+    * Output: b1c3, h2h3, a2a3 (by location)
+    **************************************/
+   void sort_likeSet()
+   {
+      // SETUP
+      MoveList moves;
+      moves.add(PackedMove("h2h3"));
+      moves.add(PackedMove("a2a3"));
+      moves.add(PackedMove("b1c3"));
+
+      // EXERCISE
+      moves.sort();
+
+      // VERIFY
+      assertUnit(moves[0].getFrom() == Position("b1").getLocation());
+      assertUnit(moves[1].getFrom() == Position("a2").getLocation());
+      assertUnit(moves[2].getFrom() == Position("h2").getLocation());
+   }  // TEARDOWN
+
+   /*************************************
+    * GET MOVES : a knight fills the list
+    * +---a-b-c-d-e-f-g-h---+
+    * |                     |
+    * 8                     8
+    * 7                     7
+    * 6                     6
+    * 5                     5
+    * 4                     4
+    * 3             p   .   3
+    * 2           P         2
+    * 1              (n)    1
+    * |                     |
+    * +---a-b-c-d-e-f-g-h---+
+    **************************************/
+   void getMoves_knight()
+   {
+      // SETUP
+      BoardEmpty board;
+      Knight knight(6, 0, true /*white*/);
+      board.board[6][0] = &knight;
+      Black black(PAWN);
+      board.board[4][1] = &black;
+      White white(PAWN);
+      board.board[5][2] = &white;
+      MoveList moves;
+      std::set<Move> movesSet;
+
+      // EXERCISE
+      knight.getMoves(moves, board);
+      knight.getMoves(movesSet, board);
+
+      // VERIFY
+      assertUnit(moves.size() == 2);
+      assertUnit(moves.contains(PackedMove("g1e2p")));
+      assertUnit(moves.contains(PackedMove("g1h3")));
+      assertUnit(movesSet.size() == 2);
+
+      // TEARDOWN
+      board.board[6][0] = nullptr;
+      board.board[4][1] = nullptr;
+      board.board[5][2] = nullptr;
+   }
+};
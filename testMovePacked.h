@@ -0,0 +1,213 @@
+/***********************************************************************
+ * Header File:
+ *    TEST PACKED MOVE
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    The unit tests for the 16-bit PackedMove
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "movePacked.h"
+
+ /***************************************************
+  * PACKED MOVE TEST
+  * Test the PackedMove class
+  ***************************************************/
+class TestPackedMove : public UnitTest
+{
+public:
+
+   void run()
+   {
+      construct_size();
+      construct_squares();
+      text_simple();
+      text_capture();
+      text_enpassant();
+      text_castle();
+      text_promotion();
+      move_capture();
+      move_roundTrip();
+
+      report("PackedMove");
+   }
+private:
+
+   /*************************************
+    * CONSTRUCT : two bytes
+    * Input:
+    * Output: sizeof == 2, null move
+    **************************************/
+   void construct_size()
+   {
+      // SETUP
+      // EXERCISE
+      PackedMove move;
+
+      // VERIFY
+      assertUnit(sizeof(PackedMove) == 2);
+      assertUnit(move.isNull());
+   }  // TEARDOWN
+
+   /*************************************
+    * CONSTRUCT : squares and flag
+    * Input:  e2 (12), e4 (28), QUIET
+    * Output: bits = 12 | 28 << 6
+    **************************************/
+   void construct_squares()
+   {
+      // SETUP
+      // EXERCISE
+      PackedMove move(12, 28, PackedMove::QUIET);
+
+      // VERIFY
+      assertUnit(move.bits == (12 | (28 << 6)));
+      assertUnit(move.getFrom() == 12);
+      assertUnit(move.getTo() == 28);
+      assertUnit(move.getFlag() == PackedMove::QUIET);
+   }  // TEARDOWN
+
+   /*************************************
+    * TEXT : simple
+    * Input:  e2e4
+    * Output: e2e4
+    **************************************/
+   void text_simple()
+   {
+      // SETUP
+      // EXERCISE
+      PackedMove move("e2e4");
+
+      // VERIFY
+      assertUnit(move.getFrom() == Position("e2").getLocation());
+      assertUnit(move.getTo()   == Position("e4").getLocation());
+      assertUnit(!move.isCapture());
+      assertUnit(move.getText() == "e2e4");
+   }  // TEARDOWN
+
+   /*************************************
+    * TEXT : capture
+    * Input:  e5c6r
+    * Output: capture flag, rook as metadata
+    **************************************/
+   void text_capture()
+   {
+      // SETUP
+      std::string text("e5c6r");
+
+      // EXERCISE
+      PackedMove move(text);
+      PieceType capture = PackedMove::captureFromText(text);
+
+      // VERIFY
+      assertUnit(move.getFlag() == PackedMove::CAPTURE);
+      assertUnit(capture == ROOK);
+      assertUnit(move.getText(capture) == text);
+   }  // TEARDOWN
+
+   /*************************************
+    * TEXT : en-passant
+    * Input:  a5b6E
+    * Output: a5b6E
+    **************************************/
+   void text_enpassant()
+   {
+      // SETUP
+      // EXERCISE
+      PackedMove move("a5b6E");
+
+      // VERIFY
+      assertUnit(move.isEnPassant());
+      assertUnit(move.isCapture());
+      assertUnit(PackedMove::captureFromText("a5b6E") == PAWN);
+      assertUnit(move.getText(PAWN) == "a5b6E");
+   }  // TEARDOWN
+
+   /*************************************
+    * TEXT : castle
+    * Input:  e1g1c, e8c8C
+    * Output: e1g1c, e8c8C
+    **************************************/
+   void text_castle()
+   {
+      // SETUP
+      // EXERCISE
+      PackedMove king("e1g1c");
+      PackedMove queen("e8c8C");
+
+      // VERIFY
+      assertUnit(king.getFlag()  == PackedMove::CASTLE_KING);
+      assertUnit(queen.getFlag() == PackedMove::CASTLE_QUEEN);
+      assertUnit(king.isCastle() && queen.isCastle());
+      assertUnit(king.getText()  == "e1g1c");
+      assertUnit(queen.getText() == "e8c8C");
+   }  // TEARDOWN
+
+   /*************************************
+    * TEXT : promotion with and without capture
+    * Input:  a7a8Q, b7a8nR
+    * Output: a7a8Q, b7a8nR
+    **************************************/
+   void text_promotion()
+   {
+      // SETUP
+      // EXERCISE
+      PackedMove quiet("a7a8Q");
+      PackedMove capture("b7a8nR");
+
+      // VERIFY
+      assertUnit(quiet.isPromotion() && !quiet.isCapture());
+      assertUnit(quiet.getPromotion() == QUEEN);
+      assertUnit(capture.isPromotion() && capture.isCapture());
+      assertUnit(capture.getPromotion() == ROOK);
+      assertUnit(quiet.getText() == "a7a8Q");
+      assertUnit(capture.getText(KNIGHT) == "b7a8nR");
+   }  // TEARDOWN
+
+   /*************************************
+    * MOVE : expand a capture
+    * Input:  e5c6 capture, rook metadata
+    * Output: Move with capture = ROOK
+    **************************************/
+   void move_capture()
+   {
+      // SETUP
+      PackedMove packed("e5c6r");
+
+      // EXERCISE
+      Move move = packed.getMove(ROOK);
+
+      // VERIFY
+      assertUnit(move.getFrom() == Position("e5"));
+      assertUnit(move.getTo()   == Position("c6"));
+      assertUnit(move.getCapturedPieceType() == ROOK);
+      assertUnit(move.getMoveType() == Move::MOVE);
+   }  // TEARDOWN
+
+   /*************************************
+    * MOVE : Move -> PackedMove -> Move
+    * Input:  a5b6 en-passant
+    * Output: the same squares and type
+    **************************************/
+   void move_roundTrip()
+   {
+      // SETUP
+      Move move(Position("a5"), Position("b6"));
+      move.setMoveType(Move::ENPASSANT);
+      move.setCapture(PAWN);
+
+      // EXERCISE
+      PackedMove packed(move);
+      Move back = packed.getMove(PAWN);
+
+      // VERIFY
+      assertUnit(packed.isEnPassant());
+      assertUnit(back.getFrom() == move.getFrom());
+      assertUnit(back.getTo()   == move.getTo());
+      assertUnit(back.getMoveType() == Move::ENPASSANT);
+      assertUnit(back.getCapturedPieceType() == PAWN);
+   }  // TEARDOWN
+};
@@ -0,0 +1,289 @@
+/***********************************************************************
+ * Header File:
+ *    TEST MOVE PICKER
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    The unit tests for the staged move picker
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "movePicker.h"
+#include "board.h"
+#include <algorithm>
+
+ /***************************************************
+  * MOVE PICKER TEST
+  * Test the MovePicker class
+  ***************************************************/
+class TestMovePicker : public UnitTest
+{
+public:
+
+   void run()
+   {
+      next_everyMoveOnce();
+      next_tableMoveFirst();
+      next_illegalTableMove();
+      next_capturesInOrder();
+      next_mvvLva();
+      next_killers();
+      next_history();
+      next_lazyQuiets();
+      next_noMoves();
+
+      report("MovePicker");
+   }
+private:
+
+   /*************************************
+    * PICK ALL
+    * Everything the picker gives, until it gives null
+    **************************************/
+   MoveList pickAll(MovePicker & picker)
+   {
+      MoveList moves;
+      for (PackedMove move = picker.next(); !move.isNull(); move = picker.next())
+         moves.add(move);
+      return moves;
+   }
+
+   /*************************************
+    * IS SAME SET
+    * The same moves, whatever the order, none twice
+    **************************************/
+   bool isSameSet(MoveList lhs, MoveList rhs)
+   {
+      std::sort(lhs.begin(), lhs.end(), [](const PackedMove & a, const PackedMove & b)
+                { return a.getBits() < b.getBits(); });
+      std::sort(rhs.begin(), rhs.end(), [](const PackedMove & a, const PackedMove & b)
+                { return a.getBits() < b.getBits(); });
+      return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+   }
+
+   /*************************************
+    * NEXT : every legal move, each once
+    * Input:  kiwipete, with a table move and two
+    *         killers, one of them the table move
+    **************************************/
+   void next_everyMoveOnce()
+   {
+      // SETUP
+      Board board;
+      board.loadFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+      MoveList legal;
+      board.generateLegalMoves(legal);
+      PackedMove castle(Position("e1"), Position("g1"), PackedMove::CASTLE_KING);
+      MovePicker picker(board, castle, PackedMove(Position("a2"), Position("a3")), castle);
+
+      // EXERCISE
+      MoveList picked = pickAll(picker);
+
+      // VERIFY
+      assertUnit(picked.size() == 48);
+      assertUnit(isSameSet(picked, legal));
+      assertUnit(picked[0] == castle);
+   }  // TEARDOWN
+
+   /*************************************
+    * NEXT : the table's move comes before the captures
+    **************************************/
+   void next_tableMoveFirst()
+   {
+      // SETUP
+      Board board;
+      board.loadFEN("4k3/8/8/3q4/8/8/3R4/3K4 w - - 0 1");
+      PackedMove tableMove(Position("d1"), Position("c1"));
+      MovePicker picker(board, tableMove);
+
+      // EXERCISE
+      PackedMove first  = picker.next();
+      PackedMove second = picker.next();
+
+      // VERIFY
+      assertUnit(first == tableMove);
+      assertUnit(second == PackedMove(Position("d2"), Position("d5"), PackedMove::CAPTURE));
+   }  // TEARDOWN
+
+   /*************************************
+    * NEXT : a table move that is not legal here, from
+    *        a collision or another position, is skipped
+    * Input:  e2e4 with no pawn on e2, and the rook
+    *         leaving the pin of the queen on d5
+    **************************************/
+   void next_illegalTableMove()
+   {
+      // SETUP
+      Board board;
+      board.loadFEN("4k3/8/8/3q4/8/8/3R4/3K4 w - - 0 1");
+      MoveList legal;
+      board.generateLegalMoves(legal);
+      MovePicker pickerEmpty(board, PackedMove(Position("e2"), Position("e4")));
+      MovePicker pickerCheck(board, PackedMove(Position("d2"), Position("e2")));
+
+      // EXERCISE
+      MoveList pickedEmpty = pickAll(pickerEmpty);
+      MoveList pickedCheck = pickAll(pickerCheck);
+
+      // VERIFY
+      assertUnit(isSameSet(pickedEmpty, legal));
+      assertUnit(isSameSet(pickedCheck, legal));
+      assertUnit(!pickedCheck.contains(PackedMove(Position("d2"), Position("e2"))));
+   }  // TEARDOWN
+
+   /*************************************
+    * NEXT : the captures that win go first, the biggest
+    *        prize first, and the ones that lose go last
+    * +---a-b-c-d-e-f-g-h---+
+    * 8           k         8
+    * 7     p               7
+    * 6       p   r         6
+    * 5                     5
+    * 4         N           4
+    * 3                     3
+    * 2                     2
+    * 1                 K   1
+    * +---a-b-c-d-e-f-g-h---+
+    * Output: Nxe6 first, Nxc6 (the b7 pawn takes back) last
+    **************************************/
+   void next_capturesInOrder()
+   {
+      // SETUP
+      Board board;
+      board.loadFEN("4k3/1p6/2p1r3/8/3N4/8/8/7K w - - 0 1");
+      MovePicker picker(board, PackedMove());
+
+      // EXERCISE
+      MoveList picked = pickAll(picker);
+
+      // VERIFY
+      assertUnit(picked.size() > 2);
+      assertUnit(picked[0] == PackedMove(Position("d4"), Position("e6"), PackedMove::CAPTURE));
+      assertUnit(picked[picked.size() - 1] == PackedMove(Position("d4"), Position("c6"), PackedMove::CAPTURE));
+   }  // TEARDOWN
+
+   /*************************************
+    * NEXT : of the good captures, the biggest victim goes
+    *        first, and of two takers the smaller one
+    * +---a-b-c-d-e-f-g-h---+
+    * 8   k                 8
+    * 7                     7
+    * 6                     6
+    * 5         q   r       5
+    * 4           P         4
+    * 3       N             3
+    * 2                     2
+    * 1     K               1
+    * +---a-b-c-d-e-f-g-h---+
+    * Output: exd5, Nxd5, exf5
+    **************************************/
+   void next_mvvLva()
+   {
+      // SETUP
+      Board board;
+      board.loadFEN("k7/8/8/3q1r2/4P3/2N5/8/1K6 w - - 0 1");
+      MovePicker picker(board, PackedMove());
+
+      // EXERCISE
+      PackedMove first  = picker.next();
+      PackedMove second = picker.next();
+      PackedMove third  = picker.next();
+
+      // VERIFY
+      assertUnit(first  == PackedMove(Position("e4"), Position("d5"), PackedMove::CAPTURE));
+      assertUnit(second == PackedMove(Position("c3"), Position("d5"), PackedMove::CAPTURE));
+      assertUnit(third  == PackedMove(Position("e4"), Position("f5"), PackedMove::CAPTURE));
+      assertUnit(mvvLva(board, first) > mvvLva(board, second));
+      assertUnit(mvvLva(board, second) > mvvLva(board, third));
+   }  // TEARDOWN
+
+   /*************************************
+    * NEXT : the killers come after the good captures and
+    *        before the other quiet moves. One that is
+    *        not legal here is left out
+    **************************************/
+   void next_killers()
+   {
+      // SETUP
+      Board board;
+      board.loadFEN("4k3/8/8/3q4/8/8/3R4/3K4 w - - 0 1");
+      PackedMove killer(Position("d1"), Position("e1"));
+      PackedMove illegal(Position("d2"), Position("e2"));     // the rook is pinned
+      MovePicker picker(board, PackedMove(), illegal, killer);
+
+      // EXERCISE
+      MoveList picked = pickAll(picker);
+
+      // VERIFY
+      assertUnit(picked[0] == PackedMove(Position("d2"), Position("d5"), PackedMove::CAPTURE));
+      assertUnit(picked[1] == killer);
+      assertUnit(!picked.contains(illegal));
+      assertUnit(std::count(picked.begin(), picked.end(), killer) == 1);
+   }  // TEARDOWN
+
+   /*************************************
+    * NEXT : the quiet moves with the best history come
+    *        first, and one with a bad history last
+    **************************************/
+   void next_history()
+   {
+      // SETUP
+      Board board;
+      ButterflyHistory history = {};
+      history[Position("g1").getLocation()][Position("f3").getLocation()] = 500;
+      history[Position("a2").getLocation()][Position("a3").getLocation()] = 200;
+      history[Position("b1").getLocation()][Position("c3").getLocation()] = -100;
+      MovePicker picker(board, PackedMove(), PackedMove(), PackedMove(), &history);
+
+      // EXERCISE
+      MoveList picked = pickAll(picker);
+
+      // VERIFY
+      assertUnit(picked.size() == 20);
+      assertUnit(picked[0] == PackedMove(Position("g1"), Position("f3")));
+      assertUnit(picked[1] == PackedMove(Position("a2"), Position("a3")));
+      assertUnit(picked[19] == PackedMove(Position("b1"), Position("c3")));
+   }  // TEARDOWN
+
+   /*************************************
+    * NEXT : the quiet moves are not generated until the
+    *        captures and killers have all been given
+    **************************************/
+   void next_lazyQuiets()
+   {
+      // SETUP
+      Board board;
+      board.loadFEN("4k3/8/8/3q4/8/8/3R4/3K4 w - - 0 1");
+      MovePicker picker(board, PackedMove());
+
+      // EXERCISE
+      PackedMove capture = picker.next();
+      bool isLazy = picker.quiets.empty();
+      PackedMove quiet = picker.next();
+
+      // VERIFY
+      assertUnit(capture == PackedMove(Position("d2"), Position("d5"), PackedMove::CAPTURE));
+      assertUnit(isLazy);
+      assertUnit(!quiet.isNull());
+      assertUnit(!quiet.isCapture());
+      assertUnit(!picker.quiets.empty());
+   }  // TEARDOWN
+
+   /*************************************
+    * NEXT : stalemate gives nothing, and keeps giving nothing
+    **************************************/
+   void next_noMoves()
+   {
+      // SETUP
+      Board board;
+      board.loadFEN("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1");
+      MovePicker picker(board, PackedMove(Position("h8"), Position("g8")));
+
+      // EXERCISE
+      // VERIFY
+      assertUnit(picker.next().isNull());
+      assertUnit(picker.next().isNull());
+   }  // TEARDOWN
+};
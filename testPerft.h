@@ -0,0 +1,498 @@
+/***********************************************************************
+ * Header File:
+ *    TEST PERFT
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    The unit tests for perft, checked against the published node
+ *    counts. A wrong count means the move generator is wrong.
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "perft.h"
+#include "board.h"
+#include <sstream>
+#include <algorithm>
+
+ /***************************************************
+  * PERFT TEST
+  * Test perft() and divide()
+  ***************************************************/
+class TestPerft : public UnitTest
+{
+public:
+
+   void run()
+   {
+      perft_start();
+      perft_kiwipete();
+      perft_endgame();
+      perft_promotions();
+      perft_position5();
+      legal_matchesPseudo();
+      legal_enPassantPinned();
+      legal_doubleCheck();
+      legal_splitByType();
+      legal_capturesInCheck();
+      divide_start();
+      perftParallel_start();
+      perftParallel_kiwipete();
+      perftCopyMake_kiwipete();
+      perftHash_probe();
+      perftHash_kiwipete();
+
+      report("Perft");
+   }
+private:
+
+   /*************************************
+    * SETUP
+    * Place pieces from the eight ranks of a FEN string, rank 8 first.
+    * Nothing else of the FEN is read; the caller sets the game state.
+    **************************************/
+   void setup(Board & board, const char * placement, int castling)
+   {
+      int col = 0;
+      int row = 7;
+      for (const char * p = placement; *p; p++)
+      {
+         if (*p == '/')
+         {
+            row--;
+            col = 0;
+         }
+         else if (*p >= '1' && *p <= '8')
+            col += *p - '0';
+         else
+         {
+            PieceType pt = SPACE;
+            switch (*p | 0x20)
+            {
+               case 'k': pt = KING;   break;
+               case 'q': pt = QUEEN;  break;
+               case 'r': pt = ROOK;   break;
+               case 'b': pt = BISHOP; break;
+               case 'n': pt = KNIGHT; break;
+               case 'p': pt = PAWN;   break;
+            }
+            board.addPiece((*p & 0x20) ? 1 : 0, pt, squareOf(col, row));
+            col++;
+         }
+      }
+      board.castling = castling;
+   }
+
+   /*************************************
+    * PERFT : start
+    * Input:  the starting position
+    * Output: 20, 400, 8902, 197281
+    **************************************/
+   void perft_start()
+   {
+      // SETUP
+      Board board;
+
+      // EXERCISE
+      // VERIFY
+      assertUnit(perft(board, 0) == 1);
+      assertUnit(perft(board, 1) == 20);
+      assertUnit(perft(board, 2) == 400);
+      assertUnit(perft(board, 3) == 8902);
+      assertUnit(perft(board, 4) == 197281);
+      assertUnit(board.getUndoDepth() == 0);
+      assertUnit(board.getOccupied() == 0xffff00000000ffffULL);
+   }  // TEARDOWN
+
+   /*************************************
+    * PERFT : kiwipete
+    * Input:  r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -
+    * Output: 48, 2039, 97862
+    **************************************/
+   void perft_kiwipete()
+   {
+      // SETUP
+      Board board(nullptr, true /*noreset*/);
+      setup(board, "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R", CASTLE_ALL);
+
+      // EXERCISE
+      // VERIFY
+      assertUnit(perft(board, 1) == 48);
+      assertUnit(perft(board, 2) == 2039);
+      assertUnit(perft(board, 3) == 97862);
+   }  // TEARDOWN
+
+   /*************************************
+    * PERFT : endgame
+    * Input:  8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -
+    * Output: 14, 191, 2812, 43238
+    **************************************/
+   void perft_endgame()
+   {
+      // SETUP
+      Board board(nullptr, true /*noreset*/);
+      setup(board, "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8", CASTLE_NONE);
+
+      // EXERCISE
+      // VERIFY
+      assertUnit(perft(board, 1) == 14);
+      assertUnit(perft(board, 2) == 191);
+      assertUnit(perft(board, 3) == 2812);
+      assertUnit(perft(board, 4) == 43238);
+   }  // TEARDOWN
+
+   /*************************************
+    * PERFT : promotions
+    * Input:  r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq -
+    * Output: 6, 264, 9467
+    **************************************/
+   void perft_promotions()
+   {
+      // SETUP
+      Board board(nullptr, true /*noreset*/);
+      setup(board, "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1",
+            CASTLE_BLACK_KING | CASTLE_BLACK_QUEEN);
+
+      // EXERCISE
+      // VERIFY
+      assertUnit(perft(board, 1) == 6);
+      assertUnit(perft(board, 2) == 264);
+      assertUnit(perft(board, 3) == 9467);
+   }  // TEARDOWN
+
+   /*************************************
+    * DIVIDE : start
+    * Input:  the starting position, depth 2
+    * Output: 20 lines of 20 and a total of 400
+    **************************************/
+   void divide_start()
+   {
+      // SETUP
+      Board board;
+      std::ostringstream out;
+
+      // EXERCISE
+      uint64_t total = divide(board, 2, out);
+
+      // VERIFY
+      assertUnit(total == 400);
+      assertUnit(out.str().find("e2e4: 20\n") != std::string::npos);
+      assertUnit(out.str().find("g1f3: 20\n") != std::string::npos);
+      assertUnit(out.str().find("Total: 400\n") != std::string::npos);
+   }  // TEARDOWN
+
+   /*************************************
+    * PERFT PARALLEL : start
+    * Input:  the starting position, depth 4 on 4 threads
+    * Output: 197281, shared out among the threads
+    **************************************/
+   void perftParallel_start()
+   {
+      // SETUP
+      Board board;
+      std::vector<uint64_t> nodesPerThread;
+
+      // EXERCISE
+      uint64_t nodes = perftParallel(board, 4, 4, &nodesPerThread);
+
+      // VERIFY
+      assertUnit(nodes == 197281);
+      assertUnit(nodesPerThread.size() == 4);
+      uint64_t sum = 0;
+      for (uint64_t n : nodesPerThread)
+         sum += n;
+      assertUnit(sum == 197281);
+      assertUnit(board.getUndoDepth() == 0);
+   }  // TEARDOWN
+
+   /*************************************
+    * PERFT PARALLEL : kiwipete
+    * Input:  kiwipete, depths 1 through 3 on 3 threads
+    * Output: 48, 2039, 97862
+    **************************************/
+   void perftParallel_kiwipete()
+   {
+      // SETUP
+      Board board(nullptr, true /*noreset*/);
+      setup(board, "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R", CASTLE_ALL);
+
+      // EXERCISE
+      // VERIFY
+      assertUnit(perftParallel(board, 1, 3) == 48);
+      assertUnit(perftParallel(board, 2, 3) == 2039);
+      assertUnit(perftParallel(board, 3, 3) == 97862);
+   }  // TEARDOWN
+
+   /*************************************
+    * PERFT COPY MAKE : kiwipete
+    * Input:  kiwipete, depths 1 through 3, restoring
+    *         snapshots instead of unmaking
+    * Output: 48, 2039, 97862, and the board untouched
+    **************************************/
+   void perftCopyMake_kiwipete()
+   {
+      // SETUP
+      Board board(nullptr, true /*noreset*/);
+      setup(board, "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R", CASTLE_ALL);
+      uint64_t key = board.getKey();
+
+      // EXERCISE
+      // VERIFY
+      assertUnit(perftCopyMake(board, 1) == 48);
+      assertUnit(perftCopyMake(board, 2) == 2039);
+      assertUnit(perftCopyMake(board, 3) == 97862);
+      assertUnit(board.getKey() == key);
+   }  // TEARDOWN
+
+   /*************************************
+    * PERFT HASH : a count comes back only for
+    *              the same key and the same depth
+    **************************************/
+   void perftHash_probe()
+   {
+      // SETUP
+      PerftHash hash(1);
+      uint64_t nodes = 0;
+
+      // EXERCISE
+      hash.store(0x1234567890abcdefULL, 3, 8902);
+
+      // VERIFY
+      assertUnit(hash.getNumEntries() == 65536);
+      assertUnit(hash.probe(0x1234567890abcdefULL, 3, nodes));
+      assertUnit(nodes == 8902);
+      assertUnit(!hash.probe(0x1234567890abcdefULL, 4, nodes));
+      assertUnit(!hash.probe(0x1234567890abcdeeULL, 3, nodes));
+      assertUnit(hash.getNumProbes() == 3);
+      assertUnit(hash.getNumHits()   == 1);
+   }  // TEARDOWN
+
+   /*************************************
+    * PERFT HASH : kiwipete
+    * Input:  kiwipete, depths 3 and 4, in a table
+    *         small enough that entries are replaced
+    * Output: 97862, 4085603, with transpositions found
+    **************************************/
+   void perftHash_kiwipete()
+   {
+      // SETUP
+      Board board(nullptr, true /*noreset*/);
+      setup(board, "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R", CASTLE_ALL);
+      uint64_t key = board.getKey();
+      PerftHash hash(1);
+
+      // EXERCISE
+      // VERIFY
+      assertUnit(perft(board, 3, hash) == 97862);
+      assertUnit(perft(board, 4, hash) == 4085603);
+      assertUnit(hash.getNumHits() > 0);
+      assertUnit(board.getKey() == key);
+      assertUnit(board.getUndoDepth() == 0);
+   }  // TEARDOWN
+
+   /*************************************
+    * PERFT : position 5
+    * Input:  rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ -
+    * Output: 44, 1486, 62379
+    **************************************/
+   void perft_position5()
+   {
+      // SETUP
+      Board board(nullptr, true /*noreset*/);
+      setup(board, "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R",
+            CASTLE_WHITE_KING | CASTLE_WHITE_QUEEN);
+
+      // EXERCISE
+      // VERIFY
+      assertUnit(perft(board, 1) == 44);
+      assertUnit(perft(board, 2) == 1486);
+      assertUnit(perft(board, 3) == 62379);
+   }  // TEARDOWN
+
+   /*************************************
+    * LEGAL MATCHES PSEUDO
+    * At every node, the legal generator gives exactly the
+    * pseudo-legal moves that do not leave the king attacked
+    **************************************/
+   bool legalMatchesPseudo(Board & board, int depth)
+   {
+      MoveList legal;
+      MoveList pseudo;
+      board.generateLegalMoves(legal);
+      board.generateMoves(pseudo);
+
+      bool fMatch = true;
+      int count = 0;
+      bool isWhite = board.whiteTurn();
+      for (const PackedMove & move : pseudo)
+      {
+         board.makeMove(move);
+         if (!board.isKingAttacked(isWhite))
+         {
+            count++;
+            if (std::find(legal.begin(), legal.end(), move) == legal.end())
+               fMatch = false;
+            if (depth > 1 && !legalMatchesPseudo(board, depth - 1))
+               fMatch = false;
+         }
+         board.unmakeMove();
+      }
+      return fMatch && count == legal.size();
+   }
+
+   /*************************************
+    * LEGAL : matches pseudo-legal
+    * Input:  kiwipete, and the promotion position
+    * Output: the two generators agree three plies deep
+    **************************************/
+   void legal_matchesPseudo()
+   {
+      // SETUP
+      Board kiwipete(nullptr, true /*noreset*/);
+      setup(kiwipete, "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R", CASTLE_ALL);
+      Board promotions(nullptr, true /*noreset*/);
+      setup(promotions, "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1",
+            CASTLE_BLACK_KING | CASTLE_BLACK_QUEEN);
+
+      // EXERCISE
+      // VERIFY
+      assertUnit(legalMatchesPseudo(kiwipete, 3));
+      assertUnit(legalMatchesPseudo(promotions, 3));
+   }  // TEARDOWN
+
+   /*************************************
+    * LEGAL : en passant that uncovers a rook on the rank
+    * Input:  8/8/8/KPp4r/8/8/8/7k w - c6
+    * Output: b5c6 is not legal; b5b6 is
+    **************************************/
+   void legal_enPassantPinned()
+   {
+      // SETUP
+      Board board(nullptr, true /*noreset*/);
+      setup(board, "8/8/8/KPp4r/8/8/8/7k", CASTLE_NONE);
+      board.enPassant = Position("c6").getLocation();
+      MoveList moves;
+
+      // EXERCISE
+      board.generateLegalMoves(moves);
+
+      // VERIFY
+      assertUnit(!moves.contains(PackedMove(Position("b5"), Position("c6"))));
+      assertUnit( moves.contains(PackedMove(Position("b5"), Position("b6"))));
+   }  // TEARDOWN
+
+   /*************************************
+    * LEGAL : double check
+    * Input:  4k3/6r1/5N2/8/8/8/8/4R1K1 b - -   knight and rook both check
+    * Output: only king moves; the rook may not block
+    **************************************/
+   void legal_doubleCheck()
+   {
+      // SETUP
+      Board board(nullptr, true /*noreset*/);
+      setup(board, "4k3/6r1/5N2/8/8/8/8/4R1K1", CASTLE_NONE);
+      board.numMoves = 1;    // black to move
+      MoveList moves;
+
+      // EXERCISE
+      board.generateLegalMoves(moves);
+
+      // VERIFY
+      assertUnit(moves.size() > 0);
+      for (const PackedMove & move : moves)
+         assertUnit(move.getFrom() == Position("e8").getLocation());
+      assertUnit(!moves.contains(PackedMove(Position("g7"), Position("e7"))));
+   }  // TEARDOWN
+
+   /*************************************
+    * SPLIT MATCHES ALL
+    * At every node, the captures and the quiet moves are
+    * each what they say, and together are all the moves
+    **************************************/
+   bool splitMatchesAll(Board & board, int depth)
+   {
+      MoveList all;
+      MoveList captures;
+      MoveList quiets;
+      board.generateLegalMoves(all);
+      board.generateLegalMoves(captures, GEN_CAPTURES);
+      board.generateLegalMoves(quiets, GEN_QUIETS);
+
+      bool fMatch = (captures.size() + quiets.size() == all.size());
+      for (const PackedMove & move : captures)
+         if (!move.isCapture() && !move.isPromotion())
+            fMatch = false;
+      for (const PackedMove & move : quiets)
+         if (move.isCapture() || move.isPromotion())
+            fMatch = false;
+      for (const PackedMove & move : all)
+      {
+         if (!captures.contains(move) && !quiets.contains(move))
+            fMatch = false;
+         if (depth > 1)
+         {
+            board.makeMove(move);
+            fMatch = splitMatchesAll(board, depth - 1) && fMatch;
+            board.unmakeMove();
+         }
+      }
+      return fMatch;
+   }
+
+   /*************************************
+    * LEGAL : split by type
+    * Input:  kiwipete, and the promotion position
+    * Output: captures and quiets add up to all the
+    *         moves, three plies deep
+    **************************************/
+   void legal_splitByType()
+   {
+      // SETUP
+      Board kiwipete(nullptr, true /*noreset*/);
+      setup(kiwipete, "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R", CASTLE_ALL);
+      Board promotions(nullptr, true /*noreset*/);
+      setup(promotions, "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1",
+            CASTLE_BLACK_KING | CASTLE_BLACK_QUEEN);
+
+      // EXERCISE
+      // VERIFY
+      assertUnit(splitMatchesAll(kiwipete, 3));
+      assertUnit(splitMatchesAll(promotions, 3));
+   }  // TEARDOWN
+
+   /*************************************
+    * LEGAL : captures when in check
+    * +---a-b-c-d-e-f-g-h---+
+    * 8               k     8
+    * 7   P                 7
+    * 6                     6
+    * 5     p P             5   en passant on b6
+    * 4                     4
+    * 3                     3
+    * 2             q       2
+    * 1           K         1
+    * +---a-b-c-d-e-f-g-h---+
+    * Output: the king takes the queen, and nothing
+    *         else; a7a8 and c5b6 do not get out of check
+    **************************************/
+   void legal_capturesInCheck()
+   {
+      // SETUP
+      Board board(nullptr, true /*noreset*/);
+      setup(board, "6k1/P7/8/1pP5/8/8/5q2/4K3", CASTLE_NONE);
+      board.enPassant = Position("b6").getLocation();
+      MoveList captures;
+      MoveList quiets;
+
+      // EXERCISE
+      board.generateLegalMoves(captures, GEN_CAPTURES);
+      board.generateLegalMoves(quiets, GEN_QUIETS);
+
+      // VERIFY
+      assertUnit(captures.size() == 1);
+      assertUnit(captures.contains(PackedMove(Position("e1"), Position("f2"), PackedMove::CAPTURE)));
+      assertUnit(quiets.size() == 1);
+      assertUnit(quiets.contains(PackedMove(Position("e1"), Position("d1"))));
+   }  // TEARDOWN
+};
@@ -0,0 +1,169 @@
+/***********************************************************************
+ * Header File:
+ *    TEST PIECE POOL
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    The unit tests for the PiecePool
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "piecePool.h"
+#include "board.h"
+
+ /***************************************************
+  * PIECE POOL TEST
+  * Test the PiecePool class
+  ***************************************************/
+class TestPiecePool : public UnitTest
+{
+public:
+
+   void run()
+   {
+      acquire_allocates();
+      acquire_recycles();
+      release_deletesDoubles();
+      reset_recycles();
+      moveUndo_recycles();
+
+      report("PiecePool");
+   }
+private:
+
+   /*************************************
+    * ACQUIRE : an empty pool goes to the heap
+    * Input:  acquire a black rook on c4
+    * Output: a new rook, counted as allocated
+    **************************************/
+   void acquire_allocates()
+   {
+      // SETUP
+      PiecePool pool;
+
+      // EXERCISE
+      Piece * pRook = pool.acquire(ROOK, 2, 3, false /*isWhite*/);
+
+      // VERIFY
+      assertUnit(pRook->getType() == ROOK);
+      assertUnit(!pRook->isWhite());
+      assertUnit(pRook->getPosition().getCol() == 2);
+      assertUnit(pRook->getPosition().getRow() == 3);
+      assertUnit(pool.getNumAllocated() == 1);
+      assertUnit(pool.getNumRecycled()  == 0);
+
+      // TEARDOWN
+      pool.release(pRook);
+   }
+
+   /*************************************
+    * ACQUIRE : a piece given back is handed out
+    *           again, as good as new
+    * Input:  release a white knight that moved,
+    *         acquire a black knight on h8
+    * Output: the same object, unmoved, black, on h8
+    **************************************/
+   void acquire_recycles()
+   {
+      // SETUP
+      PiecePool pool;
+      Piece * pFirst = pool.acquire(KNIGHT, 1, 0, true /*isWhite*/);
+      pFirst->setLastMove(3);
+      pool.release(pFirst);
+
+      // EXERCISE
+      Piece * pSecond = pool.acquire(KNIGHT, 7, 7, false /*isWhite*/);
+
+      // VERIFY
+      assertUnit(pSecond == pFirst);
+      assertUnit(pSecond->getType() == KNIGHT);
+      assertUnit(!pSecond->isWhite());
+      assertUnit(!pSecond->isMoved());
+      assertUnit(pSecond->getPosition().getLocation() == 63);
+      assertUnit(pool.getNumAllocated() == 1);
+      assertUnit(pool.getNumRecycled()  == 1);
+      assertUnit(pool.getNumReleased()  == 1);
+      assertUnit(pool.getNumFree()      == 0);
+
+      // TEARDOWN
+      pool.release(pSecond);
+   }
+
+   /*************************************
+    * RELEASE : a test double is not a real piece,
+    *           so it is deleted rather than kept
+    * Input:  release a PieceSpy posing as a knight
+    * Output: deleted, nothing on the free lists
+    **************************************/
+   void release_deletesDoubles()
+   {
+      // SETUP
+      PiecePool pool;
+      PieceSpy::reset();
+
+      // EXERCISE
+      pool.release(new PieceSpy(4, 4, true /*isWhite*/, KNIGHT));
+
+      // VERIFY
+      assertUnit(PieceSpy::numDelete == 1);
+      assertUnit(pool.getNumDeleted() == 1);
+      assertUnit(pool.getNumFree()    == 0);
+   }  // TEARDOWN
+
+   /*************************************
+    * RESET : a second reset takes every piece
+    *         from the pool and none from the heap
+    * Input:  reset a board that is already set up
+    * Output: 64 recycled, no more allocated
+    **************************************/
+   void reset_recycles()
+   {
+      // SETUP
+      Board board;
+      int numAllocated = board.getPool().getNumAllocated();
+
+      // EXERCISE
+      board.reset();
+
+      // VERIFY
+      assertUnit(numAllocated == 64);
+      assertUnit(board.getPool().getNumAllocated() == 64);
+      assertUnit(board.getPool().getNumRecycled()  == 64);
+      assertUnit(board.getPool().getNumFree()      == 0);
+   }  // TEARDOWN
+
+   /*************************************
+    * MOVE / UNDO : once a capture has been played
+    *               and taken back, doing it again
+    *               needs nothing from the heap
+    * Input:  e2e4 d7d5, then e4d5 and undo, twice
+    * Output: the second pair allocates nothing
+    **************************************/
+   void moveUndo_recycles()
+   {
+      // SETUP
+      Board board;
+      Move e2e4 = PackedMove(Position("e2"), Position("e4")).getMove();
+      Move d7d5 = PackedMove(Position("d7"), Position("d5")).getMove();
+      board.move(e2e4);
+      board.move(d7d5);
+
+      // EXERCISE
+      Move e4d5 = PackedMove(Position("e4"), Position("d5"), PackedMove::CAPTURE).getMove(PAWN);
+      board.move(e4d5);
+      board.undo(e4d5);
+      int numAllocated = board.getPool().getNumAllocated();
+      board.move(e4d5);
+      board.undo(e4d5);
+
+      // VERIFY
+      assertUnit(board.getPool().getNumAllocated() == numAllocated);
+      assertUnit(board.getPool().getNumRecycled()  >= 2);
+      assertUnit(board[Position("d5")].getType() == PAWN);
+      assertUnit(!board[Position("d5")].isWhite());
+      assertUnit(board[Position("e4")].getType() == PAWN);
+      assertUnit(board[Position("e4")].isWhite());
+   }  // TEARDOWN
+};
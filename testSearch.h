@@ -0,0 +1,475 @@
+/***********************************************************************
+ * Header File:
+ *    TEST SEARCH
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    The unit tests for the evaluation and the search
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "search.h"
+#include "board.h"
+
+ /***************************************************
+  * SEARCH TEST
+  * Test evaluate() and the Search class
+  ***************************************************/
+class TestSearch : public UnitTest
+{
+public:
+
+   void run()
+   {
+      evaluate_start();
+      evaluate_sideToMove();
+      think_mateInOne();
+      think_winQueen();
+      think_stalemate();
+      think_horizon();
+      quiesce_standPat();
+      quiesce_mate();
+      rewardQuiet_killers();
+      rewardQuiet_history();
+      clearOrdering_halves();
+      clear_forgets();
+      isRepetition_gameKeys();
+      think_leavesBoard();
+      think_nodeLimit();
+      think_sharedTable();
+      think_threadsMate();
+      think_threadsLeaveBoard();
+
+      report("Search");
+   }
+private:
+
+   /*************************************
+    * EVALUATE : the starting position is even
+    **************************************/
+   void evaluate_start()
+   {
+      // SETUP
+      Board board;
+
+      // EXERCISE
+      int score = evaluate(board);
+
+      // VERIFY
+      assertUnit(score == 0);
+   }  // TEARDOWN
+
+   /*************************************
+    * EVALUATE : the score is for the side to move
+    * Input:  white a queen up, white then black to move
+    * Output: the same score, turned around
+    **************************************/
+   void evaluate_sideToMove()
+   {
+      // SETUP
+      Board white;
+      Board black;
+      white.loadFEN("4k3/8/8/8/8/8/8/3QK3 w - - 0 1");
+      black.loadFEN("4k3/8/8/8/8/8/8/3QK3 b - - 0 1");
+
+      // EXERCISE
+      int scoreWhite = evaluate(white);
+      int scoreBlack = evaluate(black);
+
+      // VERIFY
+      assertUnit(scoreWhite > 800);
+      assertUnit(scoreBlack == -scoreWhite);
+   }  // TEARDOWN
+
+   /*************************************
+    * THINK : a back-rank mate is found at once
+    * +---a-b-c-d-e-f-g-h---+
+    * 8               k     8
+    * 7             p p p   7
+    * 1   R           K     1
+    * +---a-b-c-d-e-f-g-h---+
+    * Output: a1a8, mate in one
+    **************************************/
+   void think_mateInOne()
+   {
+      // SETUP
+      Board board;
+      board.loadFEN("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1");
+      Search search;
+
+      // EXERCISE
+      SearchResult result = search.think(board, SearchLimits(4 /*depth*/));
+
+      // VERIFY
+      assertUnit(result.bestMove == PackedMove(Position("a1"), Position("a8")));
+      assertUnit(result.score == SCORE_MATE - 1);
+      assertUnit(isMateScore(result.score));
+      assertUnit(result.pv.size() == 1);
+   }  // TEARDOWN
+
+   /*************************************
+    * THINK : a queen left hanging is taken
+    * Input:  a black queen on d5, a white rook on d2
+    * Output: d2d5, and the rook's side well ahead
+    **************************************/
+   void think_winQueen()
+   {
+      // SETUP
+      Board board;
+      board.loadFEN("4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1");
+      Search search;
+
+      // EXERCISE
+      SearchResult result = search.think(board, SearchLimits(3 /*depth*/));
+
+      // VERIFY
+      assertUnit(result.bestMove == PackedMove(Position("d2"), Position("d5"), PackedMove::CAPTURE));
+      assertUnit(result.score > 300);
+      assertUnit(result.depth == 3);
+      assertUnit(result.pv.size() == 3);
+      assertUnit(result.pv[0] == result.bestMove);
+   }  // TEARDOWN
+
+   /*************************************
+    * THINK : with no legal move and no check, it is a draw
+    * Input:  black king h8, white queen f7, king g6
+    * Output: no move, a score of 0
+    **************************************/
+   void think_stalemate()
+   {
+      // SETUP
+      Board board;
+      board.loadFEN("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1");
+      Search search;
+
+      // EXERCISE
+      SearchResult result = search.think(board, SearchLimits(3 /*depth*/));
+
+      // VERIFY
+      assertUnit(result.bestMove.isNull());
+      assertUnit(result.score == SCORE_DRAW);
+      assertUnit(result.pv.empty());
+   }  // TEARDOWN
+
+   /*************************************
+    * THINK : a capture at the last ply is answered
+    * Input:  the queen can take a pawn on d5 that the
+    *         e6 pawn defends, searched one ply deep
+    * Output: the queen does not take it
+    **************************************/
+   void think_horizon()
+   {
+      // SETUP
+      Board board;
+      board.loadFEN("4k3/8/4p3/3p4/8/8/8/3QK3 w - - 0 1");
+      Search search;
+
+      // EXERCISE
+      SearchResult result = search.think(board, SearchLimits(1 /*depth*/));
+
+      // VERIFY
+      assertUnit(!result.bestMove.isNull());
+      assertUnit(!(result.bestMove == PackedMove(Position("d1"), Position("d5"), PackedMove::CAPTURE)));
+      assertUnit(result.score > 500);
+   }  // TEARDOWN
+
+   /*************************************
+    * QUIESCE : with nothing to capture, the score is
+    *           the evaluation
+    **************************************/
+   void quiesce_standPat()
+   {
+      // SETUP
+      Board board;
+      Search search;
+
+      // EXERCISE
+      int score = search.quiesce(board, 0, -SCORE_INFINITE, SCORE_INFINITE);
+
+      // VERIFY
+      assertUnit(score == evaluate(board));
+      assertUnit(search.nodes == 1);
+      assertUnit(search.pvLength[0] == 0);
+   }  // TEARDOWN
+
+   /*************************************
+    * QUIESCE : in check there is no standing pat, and
+    *           no way out is mate
+    * Input:  the back-rank mate, already played
+    **************************************/
+   void quiesce_mate()
+   {
+      // SETUP
+      Board board;
+      board.loadFEN("R5k1/5ppp/8/8/8/8/8/6K1 b - - 1 1");
+      Search search;
+
+      // EXERCISE
+      int score = search.quiesce(board, 3, -SCORE_INFINITE, SCORE_INFINITE);
+
+      // VERIFY
+      assertUnit(score == -SCORE_MATE + 3);
+   }  // TEARDOWN
+
+   /*************************************
+    * REWARD QUIET : the newest cutoff is the first killer,
+    *                and one already first is not doubled
+    **************************************/
+   void rewardQuiet_killers()
+   {
+      // SETUP
+      Board board;
+      Search search;
+      search.clearOrdering();
+      PackedMove knight(Position("g1"), Position("f3"));
+      PackedMove pawn(Position("e2"), Position("e4"));
+      MoveList tried;
+
+      // EXERCISE
+      search.rewardQuiet(board, knight, 3, 5, tried);
+      search.rewardQuiet(board, pawn,   3, 5, tried);
+      search.rewardQuiet(board, pawn,   3, 5, tried);
+
+      // VERIFY
+      assertUnit(search.killers[5][0] == pawn);
+      assertUnit(search.killers[5][1] == knight);
+      assertUnit(search.killers[4][0].isNull());
+      assertUnit(search.killers[6][0].isNull());
+   }  // TEARDOWN
+
+   /*************************************
+    * REWARD QUIET : the move that cut off gains depth
+    *                squared, the quiet moves tried before
+    *                it lose as much, and none passes
+    *                HISTORY_MAX however often it cuts off
+    **************************************/
+   void rewardQuiet_history()
+   {
+      // SETUP
+      Board board;
+      Search search;
+      PackedMove failed(Position("a2"), Position("a3"));
+      PackedMove cutoff(Position("g1"), Position("f3"));
+      MoveList tried;
+      tried.add(failed);
+      tried.add(cutoff);
+
+      // EXERCISE
+      search.rewardQuiet(board, cutoff, 4, 0, tried);
+      int gain = search.history[0][Position("g1").getLocation()][Position("f3").getLocation()];
+      int loss = search.history[0][Position("a2").getLocation()][Position("a3").getLocation()];
+      for (int i = 0; i < 1000; i++)
+         search.rewardQuiet(board, cutoff, 20, 0, tried);
+
+      // VERIFY
+      assertUnit(gain == 16);
+      assertUnit(loss == -16);
+      assertUnit(search.history[0][Position("g1").getLocation()][Position("f3").getLocation()] <= Search::HISTORY_MAX);
+      assertUnit(search.history[0][Position("g1").getLocation()][Position("f3").getLocation()] > Search::HISTORY_MAX / 2);
+      assertUnit(search.history[0][Position("a2").getLocation()][Position("a3").getLocation()] >= -Search::HISTORY_MAX);
+      assertUnit(search.history[1][Position("g1").getLocation()][Position("f3").getLocation()] == 0);
+   }  // TEARDOWN
+
+   /*************************************
+    * CLEAR ORDERING : the killers go, and the history
+    *                  is halved
+    **************************************/
+   void clearOrdering_halves()
+   {
+      // SETUP
+      Board board;
+      Search search;
+      PackedMove cutoff(Position("g1"), Position("f3"));
+      MoveList tried;
+      tried.add(cutoff);
+      search.rewardQuiet(board, cutoff, 10, 2, tried);
+
+      // EXERCISE
+      search.clearOrdering();
+
+      // VERIFY
+      assertUnit(search.killers[2][0].isNull());
+      assertUnit(search.history[0][Position("g1").getLocation()][Position("f3").getLocation()] == 50);
+   }  // TEARDOWN
+
+   /*************************************
+    * CLEAR : the table and the history are empty again
+    **************************************/
+   void clear_forgets()
+   {
+      // SETUP
+      Board board;
+      Search search;
+      search.think(board, SearchLimits(5 /*depth*/));
+      bool isLearned = search.getTable().getPermille() > 0;
+
+      // EXERCISE
+      search.clear();
+
+      // VERIFY
+      assertUnit(isLearned);
+      assertUnit(search.getTable().getPermille() == 0);
+      bool isForgotten = true;
+      for (auto & side : search.history)
+         for (auto & from : side)
+            for (int score : from)
+               isForgotten = isForgotten && score == 0;
+      assertUnit(isForgotten);
+   }  // TEARDOWN
+
+   /*************************************
+    * IS REPETITION : a position played before the
+    *                 search started is seen again
+    * Input:  Nf3 Nf6 Ng1 Ng8, back to the start
+    * Output: a repetition only with the game keys
+    **************************************/
+   void isRepetition_gameKeys()
+   {
+      // SETUP
+      Board board;
+      Search search;
+      std::vector<uint64_t> keys;
+      const char * moves[][2] = { { "g1", "f3" }, { "g8", "f6" }, { "f3", "g1" }, { "f6", "g8" } };
+      for (auto & move : moves)
+      {
+         keys.push_back(board.getKey());
+         board.makeMove(PackedMove(Position(move[0]), Position(move[1])));
+      }
+      search.keys[0] = board.getKey();
+
+      // EXERCISE
+      bool isBefore = search.isRepetition(board, 0);
+      search.setGameKeys(keys);
+      bool isAfter = search.isRepetition(board, 0);
+      search.clear();
+      bool isCleared = search.isRepetition(board, 0);
+
+      // VERIFY
+      assertUnit(!isBefore);
+      assertUnit(isAfter);
+      assertUnit(!isCleared);
+   }  // TEARDOWN
+
+   /*************************************
+    * THINK : the board is left as it was found
+    **************************************/
+   void think_leavesBoard()
+   {
+      // SETUP
+      Board board;
+      board.loadFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+      uint64_t key = board.getKey();
+      Search search;
+
+      // EXERCISE
+      SearchResult result = search.think(board, SearchLimits(3 /*depth*/));
+
+      // VERIFY
+      assertUnit(!result.bestMove.isNull());
+      assertUnit(result.nodes > 0);
+      assertUnit(board.getKey() == key);
+      assertUnit(board.getUndoDepth() == 0);
+      assertUnit(board.toFEN() == "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+   }  // TEARDOWN
+
+   /*************************************
+    * THINK : a node limit stops the search early,
+    *         but never before there is a move
+    **************************************/
+   void think_nodeLimit()
+   {
+      // SETUP
+      Board board;
+      Search search;
+
+      // EXERCISE
+      SearchResult result = search.think(board, SearchLimits(0 /*depth*/, 0 /*ms*/, 2000 /*nodes*/));
+
+      // VERIFY
+      assertUnit(!result.bestMove.isNull());
+      assertUnit(result.depth >= 1);
+      assertUnit(result.depth < 10);
+      assertUnit(result.nodes < 4000);
+   }  // TEARDOWN
+
+   /*************************************
+    * THINK : a second search sharing the table
+    *         picks up where the first left off
+    * Input:  the same position, searched twice to depth 5
+    * Output: the same move, in far fewer nodes
+    **************************************/
+   void think_sharedTable()
+   {
+      // SETUP
+      Board board;
+      board.loadFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+      TranspositionTable table(4);
+      Search first(table);
+      Search second(table);
+
+      // EXERCISE
+      SearchResult resultFirst  = first.think(board, SearchLimits(5 /*depth*/));
+      SearchResult resultSecond = second.think(board, SearchLimits(5 /*depth*/));
+
+      // VERIFY
+      assertUnit(&first.getTable() == &second.getTable());
+      assertUnit(resultSecond.bestMove == resultFirst.bestMove);
+      assertUnit(resultSecond.score == resultFirst.score);
+      assertUnit(resultSecond.nodes * 4 < resultFirst.nodes);
+   }  // TEARDOWN
+
+   /*************************************
+    * THINK : helpers on other threads do not change
+    *         what a forced line comes to
+    * Input:  the back-rank mate, on four threads
+    * Output: a1a8, mate in one
+    **************************************/
+   void think_threadsMate()
+   {
+      // SETUP
+      Board board;
+      board.loadFEN("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1");
+      Search search;
+      search.setNumThreads(4);
+
+      // EXERCISE
+      SearchResult result = search.think(board, SearchLimits(4 /*depth*/));
+
+      // VERIFY
+      assertUnit(search.getNumThreads() == 4);
+      assertUnit(result.bestMove == PackedMove(Position("a1"), Position("a8")));
+      assertUnit(result.score == SCORE_MATE - 1);
+      assertUnit(search.helpers.empty());
+   }  // TEARDOWN
+
+   /*************************************
+    * THINK : on four threads the search still reaches the
+    *         depth asked for, counts the helpers' nodes,
+    *         and leaves the board as it was found
+    **************************************/
+   void think_threadsLeaveBoard()
+   {
+      // SETUP
+      Board board;
+      board.loadFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+      uint64_t key = board.getKey();
+      Search one;
+      Search four;
+      four.setNumThreads(4);
+
+      // EXERCISE
+      SearchResult resultOne  = one.think(board, SearchLimits(5 /*depth*/));
+      SearchResult resultFour = four.think(board, SearchLimits(5 /*depth*/));
+
+      // VERIFY
+      assertUnit(resultFour.depth == 5);
+      assertUnit(!resultFour.bestMove.isNull());
+      assertUnit(resultFour.pv.size() >= 1);
+      assertUnit(resultFour.nodes >= four.nodes);
+      assertUnit(resultOne.nodes == one.nodes);
+      assertUnit(board.getKey() == key);
+      assertUnit(board.getUndoDepth() == 0);
+   }  // TEARDOWN
+};
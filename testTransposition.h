@@ -0,0 +1,262 @@
+/***********************************************************************
+ * Header File:
+ *    TEST TRANSPOSITION
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    The unit tests for the transposition table
+ ************************************************************************/
+
+#pragma once
+
+#include "unitTest.h"
+#include "transposition.h"
+#include "position.h"
+#include <cstdint>
+
+ /***************************************************
+  * TRANSPOSITION TEST
+  * Test the TranspositionTable class
+  ***************************************************/
+class TestTransposition : public UnitTest
+{
+public:
+
+   void run()
+   {
+      construct_aligned();
+      construct_tiny();
+      store_probe();
+      probe_otherKey();
+      probe_torn();
+      store_keepsMove();
+      store_keepsDeeper();
+      store_replaceShallowest();
+      store_replaceOldest();
+      clear_empties();
+
+      report("Transposition");
+   }
+private:
+
+   /*************************************
+    * CONSTRUCT : a power of two clusters, on a
+    *             huge page boundary
+    **************************************/
+   void construct_aligned()
+   {
+      // SETUP
+      // EXERCISE
+      TranspositionTable table(6);
+
+      // VERIFY
+      assertUnit(table.getMegabytes() == 4);
+      assertUnit(table.getNumEntries() == 4 * 1024 * 1024 / 16);
+      assertUnit(table.mask == 4 * 1024 * 1024 / 64 - 1);
+      assertUnit((uintptr_t)table.clusters % (2 * 1024 * 1024) == 0);
+      assertUnit(table.getPermille() == 0);
+   }  // TEARDOWN
+
+   /*************************************
+    * CONSTRUCT : never less than one cluster
+    **************************************/
+   void construct_tiny()
+   {
+      // SETUP
+      // EXERCISE
+      TranspositionTable table(0);
+
+      // VERIFY
+      assertUnit(table.mask == 0);
+      assertUnit(table.getNumEntries() == TranspositionTable::CLUSTER_SIZE);
+      assertUnit((uintptr_t)table.clusters % 64 == 0);
+   }  // TEARDOWN
+
+   /*************************************
+    * STORE : everything stored comes back
+    * Input:  e2e4, a negative score, depth 9, a lower bound
+    **************************************/
+   void store_probe()
+   {
+      // SETUP
+      TranspositionTable table(1);
+      TTEntry entry;
+      PackedMove move(Position("e2"), Position("e4"));
+
+      // EXERCISE
+      table.store(0x123456789abcdefULL, move, -250, 9, BOUND_LOWER);
+
+      // VERIFY
+      assertUnit(table.probe(0x123456789abcdefULL, entry));
+      assertUnit(entry.move == move);
+      assertUnit(entry.score == -250);
+      assertUnit(entry.depth == 9);
+      assertUnit(entry.bound == BOUND_LOWER);
+   }  // TEARDOWN
+
+   /*************************************
+    * PROBE : another key in the same cluster misses
+    **************************************/
+   void probe_otherKey()
+   {
+      // SETUP
+      TranspositionTable table(1);
+      TTEntry entry;
+      uint64_t key = 0x0f0f0f0f00001234ULL;
+      table.store(key, PackedMove(Position("g1"), Position("f3")), 30, 4, BOUND_EXACT);
+
+      // EXERCISE
+      bool isOther = table.probe(key + table.mask + 1, entry);
+      bool isSame  = table.probe(key, entry);
+
+      // VERIFY
+      assertUnit(!isOther);
+      assertUnit(isSame);
+   }  // TEARDOWN
+
+   /*************************************
+    * PROBE : an entry whose two words were written by
+    *         two different stores is a miss, not a wrong hit
+    **************************************/
+   void probe_torn()
+   {
+      // SETUP
+      TranspositionTable table(0);
+      TTEntry entry;
+      uint64_t key = 0xdeadbeef12345678ULL;
+      table.store(key, PackedMove(Position("d2"), Position("d4")), 15, 6, BOUND_EXACT);
+      TranspositionTable::Entry * pEntry = nullptr;
+      for (TranspositionTable::Entry & e : table.clusters[0].entries)
+         if (e.data.load() != 0)
+            pEntry = &e;
+      assertUnit(pEntry != nullptr);
+      if (pEntry == nullptr)
+         return;
+
+      // EXERCISE
+      pEntry->data.store(TranspositionTable::pack(PackedMove(Position("a2"), Position("a3")),
+                                                  -900, 6, BOUND_EXACT, 0));
+
+      // VERIFY
+      assertUnit(!table.probe(key, entry));
+   }  // TEARDOWN
+
+   /*************************************
+    * STORE : a store with no move keeps the move
+    *         already there for the position
+    **************************************/
+   void store_keepsMove()
+   {
+      // SETUP
+      TranspositionTable table(1);
+      TTEntry entry;
+      PackedMove move(Position("b1"), Position("c3"));
+      table.store(77, move, 10, 3, BOUND_EXACT);
+
+      // EXERCISE
+      table.store(77, PackedMove(), -40, 4, BOUND_UPPER);
+
+      // VERIFY
+      assertUnit(table.probe(77, entry));
+      assertUnit(entry.move == move);
+      assertUnit(entry.score == -40);
+      assertUnit(entry.depth == 4);
+      assertUnit(entry.bound == BOUND_UPPER);
+   }  // TEARDOWN
+
+   /*************************************
+    * STORE : a much shallower bound does not replace a deep
+    *         entry from the same search, but an exact score does
+    **************************************/
+   void store_keepsDeeper()
+   {
+      // SETUP
+      TranspositionTable table(1);
+      TTEntry entry;
+      table.store(77, PackedMove(Position("b1"), Position("c3")), 10, 12, BOUND_EXACT);
+
+      // EXERCISE
+      table.store(77, PackedMove(Position("g1"), Position("f3")), 500, 2, BOUND_LOWER);
+      bool isKept = table.probe(77, entry) && entry.depth == 12 && entry.score == 10;
+      table.store(77, PackedMove(Position("g1"), Position("f3")), 20, 2, BOUND_EXACT);
+
+      // VERIFY
+      assertUnit(isKept);
+      assertUnit(table.probe(77, entry));
+      assertUnit(entry.depth == 2);
+      assertUnit(entry.score == 20);
+   }  // TEARDOWN
+
+   /*************************************
+    * STORE : in a full cluster the shallowest entry goes
+    * Input:  depths 5, 2, 7, 4, then a fifth position
+    * Output: the depth 2 entry is the one missing
+    **************************************/
+   void store_replaceShallowest()
+   {
+      // SETUP
+      TranspositionTable table(0);
+      TTEntry entry;
+      table.store(1, PackedMove(), 0, 5, BOUND_EXACT);
+      table.store(2, PackedMove(), 0, 2, BOUND_EXACT);
+      table.store(3, PackedMove(), 0, 7, BOUND_EXACT);
+      table.store(4, PackedMove(), 0, 4, BOUND_EXACT);
+
+      // EXERCISE
+      table.store(5, PackedMove(), 0, 1, BOUND_EXACT);
+
+      // VERIFY
+      assertUnit(table.probe(1, entry));
+      assertUnit(!table.probe(2, entry));
+      assertUnit(table.probe(3, entry));
+      assertUnit(table.probe(4, entry));
+      assertUnit(table.probe(5, entry));
+   }  // TEARDOWN
+
+   /*************************************
+    * STORE : an entry a few searches old goes before a
+    *         shallower one from this search
+    * Input:  depth 10 two searches ago, then 3 entries
+    *         of depth 1 through 3 in this one
+    * Output: the depth 10 entry is the one missing
+    **************************************/
+   void store_replaceOldest()
+   {
+      // SETUP
+      TranspositionTable table(0);
+      TTEntry entry;
+      table.store(1, PackedMove(), 0, 10, BOUND_EXACT);
+      table.newSearch();
+      table.newSearch();
+      table.store(2, PackedMove(), 0, 1, BOUND_EXACT);
+      table.store(3, PackedMove(), 0, 2, BOUND_EXACT);
+      table.store(4, PackedMove(), 0, 3, BOUND_EXACT);
+
+      // EXERCISE
+      table.store(5, PackedMove(), 0, 1, BOUND_EXACT);
+
+      // VERIFY
+      assertUnit(!table.probe(1, entry));
+      assertUnit(table.probe(2, entry));
+      assertUnit(table.probe(5, entry));
+      assertUnit(table.getPermille() == 1000);
+   }  // TEARDOWN
+
+   /*************************************
+    * CLEAR : nothing is found afterwards
+    **************************************/
+   void clear_empties()
+   {
+      // SETUP
+      TranspositionTable table(1);
+      TTEntry entry;
+      table.store(99, PackedMove(Position("e7"), Position("e5")), 0, 3, BOUND_EXACT);
+
+      // EXERCISE
+      table.clear();
+
+      // VERIFY
+      assertUnit(!table.probe(99, entry));
+      assertUnit(table.getPermille() == 0);
+   }  // TEARDOWN
+};
@@ -0,0 +1,223 @@
+/***********************************************************************
+ * Source File:
+ *    TRANSPOSITION TABLE
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    The lock-free table the search threads share
+ ************************************************************************/
+
+#include "transposition.h"
+#include <cassert>
+#include <cstdlib>
+#include <new>
+#if defined(_MSC_VER)
+#include <malloc.h>      // for _ALIGNED_MALLOC
+#elif defined(__linux__)
+#include <sys/mman.h>    // for MADVISE
+#endif
+using namespace std;
+
+/***************************************************
+ * ALIGNMENT
+ * A table of 2 MB or more starts on a 2 MB boundary so
+ * the operating system can back it with huge pages, and
+ * a probe is less likely to miss in the TLB as well as
+ * in the cache. A smaller one only needs whole cache lines
+ ***************************************************/
+static const size_t HUGE_PAGE = 2 * 1024 * 1024;
+
+static void * allocateAligned(size_t numBytes)
+{
+   size_t alignment = (numBytes >= HUGE_PAGE) ? HUGE_PAGE : 64;
+   void * p = nullptr;
+#if defined(_MSC_VER)
+   p = _aligned_malloc(numBytes, alignment);
+#else
+   if (posix_memalign(&p, alignment, numBytes) != 0)
+      p = nullptr;
+#endif
+   if (!p)
+      throw bad_alloc();
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+   if (alignment == HUGE_PAGE)
+      madvise(p, numBytes, MADV_HUGEPAGE);
+#endif
+   return p;
+}
+
+static void freeAligned(void * p)
+{
+#if defined(_MSC_VER)
+   _aligned_free(p);
+#else
+   free(p);
+#endif
+}
+
+/***************************************************
+ * TRANSPOSITION TABLE : CONSTRUCTOR
+ ***************************************************/
+TranspositionTable::TranspositionTable(size_t megabytes)
+   : clusters(nullptr), mask(0), numBytes(0), generation(0)
+{
+   resize(megabytes);
+}
+
+/***************************************************
+ * TRANSPOSITION TABLE : DESTRUCTOR
+ ***************************************************/
+TranspositionTable::~TranspositionTable()
+{
+   freeAligned(clusters);
+}
+
+/***************************************************
+ * TRANSPOSITION TABLE : RESIZE
+ * At least one cluster, however small the size asked for
+ ***************************************************/
+void TranspositionTable::resize(size_t megabytes)
+{
+   size_t numClusters = 1;
+   while (numClusters * 2 * sizeof(Cluster) <= megabytes * 1024 * 1024)
+      numClusters *= 2;
+
+   if (clusters)
+      freeAligned(clusters);
+   numBytes = numClusters * sizeof(Cluster);
+   clusters = static_cast<Cluster *>(allocateAligned(numBytes));
+   mask = numClusters - 1;
+   clear();
+}
+
+/***************************************************
+ * TRANSPOSITION TABLE : CLEAR
+ ***************************************************/
+void TranspositionTable::clear()
+{
+   for (size_t i = 0; i <= mask; i++)
+      for (Entry & entry : clusters[i].entries)
+      {
+         entry.keyXorData.store(0, memory_order_relaxed);
+         entry.data.store(0, memory_order_relaxed);
+      }
+   generation = 0;
+}
+
+/***************************************************
+ * TRANSPOSITION TABLE : PACK
+ * The move in the low 16 bits, then the score, the
+ * depth, the bound and the generation
+ ***************************************************/
+uint64_t TranspositionTable::pack(const PackedMove & move, int score, int depth,
+                                  TTBound bound, int generation)
+{
+   assert(score > -32768 && score < 32768);
+   assert(depth >= 0 && depth < 256);
+   return (uint64_t)move.getBits()                  |
+          (uint64_t)(uint16_t)(int16_t)score << 16  |
+          (uint64_t)depth                    << 32  |
+          (uint64_t)bound                    << 40  |
+          (uint64_t)generation               << 42;
+}
+
+/***************************************************
+ * UNPACK MOVE
+ * The move from the low 16 bits of the data
+ ***************************************************/
+static PackedMove unpackMove(uint64_t data)
+{
+   return PackedMove((int)(data & 0x3f), (int)((data >> 6) & 0x3f), (int)((data >> 12) & 0xf));
+}
+
+/***************************************************
+ * TRANSPOSITION TABLE : PROBE
+ * The two words are read without a lock. If another
+ * thread wrote one of them in between, they no longer
+ * XOR back to the key and the entry is a miss
+ ***************************************************/
+bool TranspositionTable::probe(uint64_t key, TTEntry & entry) const
+{
+   const Cluster & cluster = clusters[key & mask];
+   for (const Entry & e : cluster.entries)
+   {
+      uint64_t data = e.data.load(memory_order_relaxed);
+      if ((e.keyXorData.load(memory_order_relaxed) ^ data) != key)
+         continue;
+
+      entry.bound = (TTBound)((data >> 40) & 3);
+      if (entry.bound == BOUND_NONE)
+         return false;
+      entry.move  = unpackMove(data);
+      entry.score = (int16_t)(uint16_t)(data >> 16);
+      entry.depth = (int)((data >> 32) & 0xff);
+      return true;
+   }
+   return false;
+}
+
+/***************************************************
+ * TRANSPOSITION TABLE : STORE
+ * A position already in the cluster is updated, keeping
+ * its move if there is no new one, unless it was searched
+ * deeper this same search. Otherwise the new position
+ * takes the place of the entry worth least: an empty one,
+ * or the shallowest, where each search of age counts
+ * as much as eight plies of depth
+ ***************************************************/
+void TranspositionTable::store(uint64_t key, const PackedMove & move, int score,
+                               int depth, TTBound bound)
+{
+   Cluster & cluster = clusters[key & mask];
+   PackedMove keep = move;
+   Entry * pReplace = nullptr;
+   int worthReplace = 0;
+   for (Entry & e : cluster.entries)
+   {
+      uint64_t data = e.data.load(memory_order_relaxed);
+      if ((e.keyXorData.load(memory_order_relaxed) ^ data) == key)
+      {
+         int oldDepth = (int)((data >> 32) & 0xff);
+         int oldGeneration = (int)((data >> 42) & GENERATION_MASK);
+         if (bound != BOUND_EXACT && oldGeneration == generation && depth < oldDepth - 2)
+            return;
+         if (keep.isNull())
+            keep = unpackMove(data);
+         pReplace = &e;
+         break;
+      }
+
+      int age = (generation - (int)((data >> 42) & GENERATION_MASK)) & GENERATION_MASK;
+      int worth = (((data >> 40) & 3) == BOUND_NONE) ? -1000 :
+                  (int)((data >> 32) & 0xff) - 8 * age;
+      if (!pReplace || worth < worthReplace)
+      {
+         pReplace = &e;
+         worthReplace = worth;
+      }
+   }
+
+   uint64_t packed = pack(keep, score, depth, bound, generation);
+   pReplace->data.store(packed, memory_order_relaxed);
+   pReplace->keyXorData.store(key ^ packed, memory_order_relaxed);
+}
+
+/***************************************************
+ * TRANSPOSITION TABLE : PERMILLE
+ * Sampled from the first thousand clusters, or all
+ * of them in a smaller table
+ ***************************************************/
+int TranspositionTable::getPermille() const
+{
+   size_t numSampled = (mask + 1 < 1000) ? mask + 1 : 1000;
+   size_t numUsed = 0;
+   for (size_t i = 0; i < numSampled; i++)
+      for (const Entry & e : clusters[i].entries)
+      {
+         uint64_t data = e.data.load(memory_order_relaxed);
+         if (((data >> 40) & 3) != BOUND_NONE &&
+             (int)((data >> 42) & GENERATION_MASK) == generation)
+            numUsed++;
+      }
+   return (int)(numUsed * 1000 / (numSampled * CLUSTER_SIZE));
+}
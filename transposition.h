@@ -0,0 +1,120 @@
+/***********************************************************************
+ * Header File:
+ *    TRANSPOSITION TABLE
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    What the search has already learned about a position, keyed by
+ *    its Zobrist key: the best move found, the score and how deep it
+ *    was searched. Every search thread reads and writes the same table
+ *    without a lock. Each entry is stored as two words, the data and
+ *    the key XORed with the data, so an entry torn by two threads
+ *    writing at once no longer matches its key and is simply missed.
+ ************************************************************************/
+
+#pragma once
+
+#include "movePacked.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <xmmintrin.h>   // for _MM_PREFETCH
+#endif
+
+class TestTransposition;
+
+/***************************************************
+ * TT BOUND
+ * How the score relates to the true score of the position
+ ***************************************************/
+enum TTBound : uint8_t
+{
+   BOUND_NONE  = 0,
+   BOUND_UPPER = 1,       // every move failed low: the score is at most this
+   BOUND_LOWER = 2,       // a move failed high: the score is at least this
+   BOUND_EXACT = 3
+};
+
+/***************************************************
+ * TT ENTRY
+ * One probe's answer, unpacked from the 64 bits of data
+ ***************************************************/
+struct TTEntry
+{
+   PackedMove move;        // null if no move was best
+   int        score;       // as stored, see Search for mate scores
+   int        depth;
+   TTBound    bound;
+};
+
+/***************************************************
+ * TRANSPOSITION TABLE
+ * Clusters of four entries fill one 64-byte cache line, so
+ * a probe costs one memory access, which prefetch() can
+ * start as soon as the key is known. A position replaces
+ * the entry in its cluster that is shallowest and oldest,
+ * counting age in searches (generations)
+ ***************************************************/
+class TranspositionTable
+{
+   friend TestTransposition;
+public:
+   static const int CLUSTER_SIZE = 4;
+
+   // a table of about megabytes MB, rounded down to a power of two
+   TranspositionTable(size_t megabytes = 16);
+   ~TranspositionTable();
+   TranspositionTable(const TranspositionTable & rhs) = delete;
+   TranspositionTable & operator = (const TranspositionTable & rhs) = delete;
+
+   // resize drops everything stored; neither may run during a search
+   void resize(size_t megabytes);
+   void clear();
+
+   // a new search: what is stored from now on is younger than before
+   void newSearch() { generation = (generation + 1) & GENERATION_MASK; }
+
+   // the entry for this key, if there is one
+   bool probe(uint64_t key, TTEntry & entry) const;
+   void store(uint64_t key, const PackedMove & move, int score, int depth, TTBound bound);
+
+   // start loading the key's cluster into the cache
+   void prefetch(uint64_t key) const
+   {
+#if defined(_MSC_VER)
+      _mm_prefetch((const char *)&clusters[key & mask], _MM_HINT_T0);
+#else
+      __builtin_prefetch(&clusters[key & mask]);
+#endif
+   }
+
+   size_t getNumEntries() const { return (mask + 1) * CLUSTER_SIZE; }
+   size_t getMegabytes()  const { return (mask + 1) * sizeof(Cluster) / (1024 * 1024); }
+
+   // how full the table is with this search's entries, per thousand
+   int getPermille() const;
+
+private:
+   static const int GENERATION_MASK = 0x3f;
+
+   // the data is the move, the score, the depth, the bound and the
+   // generation. The other word is the key XORed with all of that
+   struct Entry
+   {
+      std::atomic<uint64_t> keyXorData;
+      std::atomic<uint64_t> data;
+   };
+   struct alignas(64) Cluster
+   {
+      Entry entries[CLUSTER_SIZE];
+   };
+   static_assert(sizeof(Cluster) == 64, "a cluster must fill one cache line");
+
+   static uint64_t pack(const PackedMove & move, int score, int depth, TTBound bound, int generation);
+
+   Cluster * clusters;
+   size_t    mask;
+   size_t    numBytes;       // as allocated
+   uint8_t   generation;
+};
@@ -0,0 +1,37 @@
+/***********************************************************************
+ * Source File:
+ *    USER INTERFACE DRAW : NONE
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    The graphics stream for the programs that open no window, such as
+ *    Perft. Board and the pieces can still be asked to display()
+ *    themselves, but nothing is drawn, so these programs build and
+ *    run without OpenGL or GLUT. Link this in place of uiDraw.cpp
+ ************************************************************************/
+
+#include "uiDraw.h"
+
+/*************************************************************************
+ * FLUSH
+ * The text has nowhere to go, so it is thrown away
+ *************************************************************************/
+void ogstream::flush()
+{
+   str("");
+}
+
+/*************************************************************************
+ * DRAW
+ * Nothing to draw on
+ *************************************************************************/
+void ogstream::drawKing  (const Position&, bool) { }
+void ogstream::drawQueen (const Position&, bool) { }
+void ogstream::drawRook  (const Position&, bool) { }
+void ogstream::drawPawn  (const Position&, bool) { }
+void ogstream::drawBishop(const Position&, bool) { }
+void ogstream::drawKnight(const Position&, bool) { }
+void ogstream::drawBoard()                        { }
+void ogstream::drawSelected(const Position&)      { }
+void ogstream::drawHover   (const Position&)      { }
+void ogstream::drawPossible(const Position&)      { }
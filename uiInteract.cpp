@@ -225,9 +225,6 @@ void *        Interface::p             = NULL;
 void (*Interface::callBack)(Interface *, void *) = NULL;
 char          Interface::key          = '\0';
 
-double Position::squareWidth  = (double)SIZE_SQUARE;
-double Position::squareHeight = (double)SIZE_SQUARE;
-
 /***************************************************************
  * KEYBOARD CALLBACK
  * Generic callback to a regular ascii keyboard event, such as
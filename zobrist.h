@@ -0,0 +1,66 @@
+/***********************************************************************
+ * Header File:
+ *    ZOBRIST
+ * Author:
+ *    Chris Mijangos and Seth Chen
+ * Summary:
+ *    The random numbers behind the 64-bit position key. A position's
+ *    key is the XOR of the number for every piece on its square, for
+ *    the castling rights, for the en-passant file, and for black to
+ *    move. Moving a piece is then two XORs rather than a recount.
+ *    The numbers are made at compile time from a fixed seed so every
+ *    build, and every run, gives a position the same key.
+ ************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+
+/***************************************************
+ * ZOBRIST KEYS
+ ***************************************************/
+struct ZobristKeys
+{
+   uint64_t pieces[2][8][64];   // [white, black][PieceType][location]
+   uint64_t castling[16];       // [CastleRight bits]; no rights is 0
+   uint64_t enPassant[8];       // [column of the en-passant square]
+   uint64_t blackToMove;
+};
+
+/***************************************************
+ * SPLIT MIX 64
+ * A small, well-mixed pseudo-random sequence
+ ***************************************************/
+constexpr uint64_t splitMix64(uint64_t & state)
+{
+   state += 0x9e3779b97f4a7c15ULL;
+   uint64_t z = state;
+   z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+   z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+   return z ^ (z >> 31);
+}
+
+constexpr ZobristKeys makeZobristKeys()
+{
+   ZobristKeys keys = {};
+   uint64_t state = 0x43686573734c6162ULL;
+   for (int c = 0; c < 2; c++)
+      for (int pt = 0; pt < 8; pt++)
+         for (int location = 0; location < 64; location++)
+            keys.pieces[c][pt][location] = splitMix64(state);
+
+   // each right gets a number; a set of rights is the XOR of its members
+   uint64_t rights[4] = { splitMix64(state), splitMix64(state),
+                          splitMix64(state), splitMix64(state) };
+   for (int bits = 0; bits < 16; bits++)
+      for (int i = 0; i < 4; i++)
+         if (bits & (1 << i))
+            keys.castling[bits] ^= rights[i];
+
+   for (int col = 0; col < 8; col++)
+      keys.enPassant[col] = splitMix64(state);
+   keys.blackToMove = splitMix64(state);
+   return keys;
+}
+
+inline constexpr ZobristKeys ZOBRIST = makeZobristKeys();